@@ -19,6 +19,9 @@
 
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSFeatures.h"
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSFile.h"
+#if CLS_COMPACT_UNWINDING_SUPPORTED
+#include "Crashlytics/Crashlytics/Unwind/Compact/FIRCLSCompactUnwind.h"
+#endif
 #include "Crashlytics/Shared/FIRCLSMachO/FIRCLSMachO.h"
 
 __BEGIN_DECLS
@@ -38,6 +41,7 @@ typedef struct {
 #endif
 #if CLS_COMPACT_UNWINDING_SUPPORTED
   const void* unwindInfo;
+  FIRCLSCompactUnwindImageInfo unwindImageInfo;
 #endif
   const void* crashInfo;
 #if CLS_BINARY_IMAGE_RUNTIME_NODE_RECORD_NAME
@@ -341,6 +341,7 @@ static bool FIRCLSBinaryImageFillInImageDetails(FIRCLSBinaryImageDetails* detail
   if (FIRCLSBinaryImageMachOSliceInitSectionByName(&details->slice, SEG_TEXT, "__unwind_info",
                                                    &section)) {
     details->node.unwindInfo = (void*)(section.addr + details->vmaddr_slide);
+    FIRCLSCompactUnwindImageInfoInit(&details->node.unwindImageInfo, details->node.unwindInfo);
   }
 #endif
 
@@ -23,6 +23,7 @@
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSAllocate.h"
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSFeatures.h"
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSInternalLogging.h"
+#include "Crashlytics/Crashlytics/Unwind/Dwarf/FIRCLSDwarfUnwind.h"
 
 #include <dispatch/dispatch.h>
 #include <stdbool.h>
@@ -72,6 +73,9 @@ typedef struct {
   FIRCLSBinaryImageReadWriteContext binaryImage;
   FIRCLSUserLoggingWritableContext logging;
   FIRCLSExceptionWritableContext exception;
+#if CLS_DWARF_UNWINDING_SUPPORTED
+  FIRCLSDwarfUnwindCache dwarfUnwindCache;
+#endif
 } FIRCLSReadWriteContext;
 
 typedef struct {
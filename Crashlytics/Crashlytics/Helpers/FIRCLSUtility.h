@@ -24,7 +24,9 @@
 
 __BEGIN_DECLS
 
+#if __BLOCKS__
 void FIRCLSLookupFunctionPointer(void* ptr, void (^block)(const char* name, const char* lib));
+#endif
 
 void FIRCLSHexFromByte(uint8_t c, char output[]);
 uint8_t FIRCLSNybbleFromChar(char c);
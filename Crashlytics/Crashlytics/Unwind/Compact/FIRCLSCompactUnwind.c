@@ -25,14 +25,69 @@
 #if CLS_COMPACT_UNWINDING_SUPPORTED
 
 #pragma mark Parsing
+bool FIRCLSCompactUnwindImageInfoInit(FIRCLSCompactUnwindImageInfo* info, const void* unwindInfo) {
+  if (!FIRCLSIsValidPointer(info)) {
+    return false;
+  }
+
+  memset(info, 0, sizeof(FIRCLSCompactUnwindImageInfo));
+
+  if (!FIRCLSIsValidPointer(unwindInfo)) {
+    return false;
+  }
+
+  if (!FIRCLSReadMemory((vm_address_t)unwindInfo, &info->header,
+                        sizeof(struct unwind_info_section_header))) {
+    FIRCLSSDKLog("Error: could not read memory contents of unwindInfo\n");
+    return false;
+  }
+
+  if (info->header.version != UNWIND_SECTION_VERSION) {
+    FIRCLSSDKLog("Error: bad unwind_info structure version (%d != %d)\n", info->header.version,
+                 UNWIND_SECTION_VERSION);
+    return false;
+  }
+
+  info->valid = true;
+
+  return true;
+}
+
 bool FIRCLSCompactUnwindInit(FIRCLSCompactUnwindContext* context,
                              const void* unwindInfo,
                              const void* ehFrame,
                              uintptr_t loadAddress) {
+  FIRCLSCompactUnwindImageInfo info;
+
+  if (!FIRCLSCompactUnwindImageInfoInit(&info, unwindInfo)) {
+    FIRCLSSDKLog("Error: invalid unwind info passed to compact unwind init");
+    return false;
+  }
+
+  if (!FIRCLSIsValidPointer(context)) {
+    FIRCLSSDKLog("Error: invalid context passed to compact unwind init");
+    return false;
+  }
+
+  // make sure nothing from a previous image is reused
+  memset(context, 0, sizeof(FIRCLSCompactUnwindContext));
+
+  return FIRCLSCompactUnwindInitWithImageInfo(context, &info, unwindInfo, ehFrame, loadAddress);
+}
+
+bool FIRCLSCompactUnwindInitWithImageInfo(FIRCLSCompactUnwindContext* context,
+                                          const FIRCLSCompactUnwindImageInfo* info,
+                                          const void* unwindInfo,
+                                          const void* ehFrame,
+                                          uintptr_t loadAddress) {
   if (!FIRCLSIsValidPointer(context)) {
     FIRCLSSDKLog("Error: invalid context passed to compact unwind init");
     return false;
   }
+  if (!FIRCLSIsValidPointer(info) || !info->valid) {
+    FIRCLSSDKLog("Error: invalid image info passed to compact unwind init");
+    return false;
+  }
   if (!FIRCLSIsValidPointer(unwindInfo)) {
     FIRCLSSDKLog("Error: invalid unwind info passed to compact unwind init");
     return false;
@@ -42,21 +97,17 @@ bool FIRCLSCompactUnwindInit(FIRCLSCompactUnwindContext* context,
     return false;
   }
 
-  memset(context, 0, sizeof(FIRCLSCompactUnwindContext));
-
-  if (!FIRCLSReadMemory((vm_address_t)unwindInfo, &context->unwindHeader,
-                        sizeof(struct unwind_info_section_header))) {
-    FIRCLSSDKLog("Error: could not read memory contents of unwindInfo\n");
-    return false;
+  // Consecutive frames are frequently in the same image. In that case, keep the last first-level
+  // entry we found, since the next pc is likely to be covered by it too.
+  if (context->unwindInfo == unwindInfo && context->loadAddress == loadAddress) {
+    context->ehFrame = ehFrame;
+    return true;
   }
 
-  if (context->unwindHeader.version != UNWIND_SECTION_VERSION) {
-    FIRCLSSDKLog("Error: bad unwind_info structure version (%d != %d)\n",
-                 context->unwindHeader.version, UNWIND_SECTION_VERSION);
-    return false;
-  }
+  memset(context, 0, sizeof(FIRCLSCompactUnwindContext));
 
   // copy in the values
+  context->unwindHeader = info->header;
   context->unwindInfo = unwindInfo;
   context->ehFrame = ehFrame;
   context->loadAddress = loadAddress;
@@ -87,7 +138,7 @@ uintptr_t FIRCLSCompactUnwindGetIndexFunctionOffset(FIRCLSCompactUnwindContext*
 uintptr_t FIRCLSCompactUnwindGetTargetAddress(FIRCLSCompactUnwindContext* context, uintptr_t pc) {
   uintptr_t offset = FIRCLSCompactUnwindGetIndexFunctionOffset(context);
 
-  if (pc <= offset) {
+  if (pc < offset) {
     FIRCLSSDKLog("Error: PC is invalid\n");
     return 0;
   }
@@ -124,19 +175,39 @@ bool FIRCLSCompactUnwindLookupFirstLevel(FIRCLSCompactUnwindContext* context, ui
 
   address -= context->loadAddress;  // search relative to zero
 
-  // minus one because of the extra entry - see comment above
-  for (uint32_t index = 0; index < indexCount - 1; ++index) {
-    uint32_t value = indexEntries[index].functionOffset;
-    uint32_t nextValue = indexEntries[index + 1].functionOffset;
+  // check the entry found for the previous frame first
+  if (context->firstLevelNextFunctionOffset != 0 &&
+      address >= context->indexHeader.functionOffset &&
+      address < context->firstLevelNextFunctionOffset) {
+    return true;
+  }
+
+  // The entries are sorted by function offset, so binary search for the last one that starts at or
+  // before the address. The extra entry at the end only marks where the final range stops, and
+  // is never a match itself (minus one - see comment above).
+  uint32_t lowIndex = 0;
+  uint32_t highIndex = indexCount - 1;
+
+  if (address < indexEntries[lowIndex].functionOffset ||
+      address >= indexEntries[highIndex].functionOffset) {
+    return false;
+  }
+
+  // invariant: entries[lowIndex].functionOffset <= address < entries[highIndex].functionOffset
+  while (highIndex - lowIndex > 1) {
+    uint32_t midIndex = lowIndex + (highIndex - lowIndex) / 2;
 
-    if (address >= value && address < nextValue) {
-      context->firstLevelNextFunctionOffset = nextValue;
-      context->indexHeader = indexEntries[index];
-      return true;
+    if (indexEntries[midIndex].functionOffset <= address) {
+      lowIndex = midIndex;
+    } else {
+      highIndex = midIndex;
     }
   }
 
-  return false;
+  context->firstLevelNextFunctionOffset = indexEntries[highIndex].functionOffset;
+  context->indexHeader = indexEntries[lowIndex];
+
+  return true;
 }
 
 uint32_t FIRCLSCompactUnwindGetSecondLevelPageKind(FIRCLSCompactUnwindContext* context) {
@@ -167,47 +238,30 @@ bool FIRCLSCompactUnwindBinarySearchSecondLevel(uintptr_t address,
     return false;
   }
 
-  if (address == 0) {
-    return false;
-  }
-
+  // Find the last entry that starts at or before the address. The first entry can start at offset
+  // zero, and the last one runs up to the next first-level entry, so both can match.
+  uint32_t lowIndex = 0;
   uint32_t highIndex = entryCount;
-  *index = 0;
-
-  while (*index < highIndex) {
-    uint32_t midIndex = (*index + highIndex) / 2;
-
-    //        FIRCLSSDKLog("%u %u %u\n", *index, midIndex, highIndex);
 
-    uintptr_t value = UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(entryArray[midIndex]);
+  if (address < UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(entryArray[lowIndex])) {
+    return false;
+  }
 
-    if (value > address) {
-      if (highIndex == midIndex) {
-        return false;
-      }
+  // invariant: entries[lowIndex] <= address < entries[highIndex], taking entries[entryCount] to be
+  // past every address
+  while (highIndex - lowIndex > 1) {
+    uint32_t midIndex = lowIndex + (highIndex - lowIndex) / 2;
 
+    if (UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(entryArray[midIndex]) <= address) {
+      lowIndex = midIndex;
+    } else {
       highIndex = midIndex;
-      continue;
     }
-
-    *index = midIndex;
-
-    // are we at the end of the array?
-    if (midIndex == entryCount - 1) {
-      return false;
-    }
-
-    uintptr_t nextValue = UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(entryArray[midIndex + 1]);
-    if (nextValue > address) {
-      // we've found it
-      break;
-    }
-
-    *index += 1;
   }
 
-  // check to make sure we're still within bounds
-  return *index < entryCount;
+  *index = lowIndex;
+
+  return true;
 }
 
 bool FIRCLSCompactUnwindLookupSecondLevelCompressed(FIRCLSCompactUnwindContext* context,
@@ -390,7 +444,8 @@ bool FIRCLSCompactUnwindDwarfFrame(FIRCLSCompactUnwindContext* context,
     return false;
   }
 
-  if (!FIRCLSDwarfUnwindComputeRegisters(&record, registers)) {
+  if (!FIRCLSDwarfUnwindComputeRegistersWithCache(&record, registers,
+                                                  context->dwarfUnwindCache)) {
     FIRCLSSDKLogError("Failed to compute DWARF registers\n");
     return false;
   }
@@ -19,6 +19,9 @@
 
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSFeatures.h"
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSThreadState.h"
+#if CLS_DWARF_UNWINDING_SUPPORTED
+#include "Crashlytics/Crashlytics/Unwind/Dwarf/FIRCLSDwarfUnwind.h"
+#endif
 
 // We have to pack the arrays defined in this header, so
 // we can reason about pointer math.
@@ -32,6 +35,13 @@
 // Its output is undefined if the input is zero.
 #define GET_BITS_WITH_MASK(value, mask) ((value & mask) >> (mask == 0 ? 0 : __builtin_ctz(mask)))
 
+// The parts of an image's __unwind_info that are needed for every lookup in it. These are read and
+// validated once, when the image is loaded, so unwinding doesn't have to do it for every frame.
+typedef struct {
+  struct unwind_info_section_header header;
+  bool valid;
+} FIRCLSCompactUnwindImageInfo;
+
 typedef struct {
   const void* unwindInfo;
   const void* ehFrame;
@@ -40,6 +50,11 @@ typedef struct {
   struct unwind_info_section_header unwindHeader;
   struct unwind_info_section_header_index_entry indexHeader;
   uint32_t firstLevelNextFunctionOffset;
+#if CLS_DWARF_UNWINDING_SUPPORTED
+  // Optional, and cleared whenever the context is set up for a new image. Callers that unwind many
+  // frames can set it afterwards so repeated DWARF frames skip reinterpreting their CFI.
+  FIRCLSDwarfUnwindCache* dwarfUnwindCache;
+#endif
 } FIRCLSCompactUnwindContext;
 
 typedef struct {
@@ -51,15 +66,20 @@ typedef struct {
 
 } FIRCLSCompactUnwindResult;
 
+bool FIRCLSCompactUnwindImageInfoInit(FIRCLSCompactUnwindImageInfo* info, const void* unwindInfo);
 bool FIRCLSCompactUnwindInit(FIRCLSCompactUnwindContext* context,
                              const void* unwindInfo,
                              const void* ehFrame,
                              uintptr_t loadAddress);
+// Unlike FIRCLSCompactUnwindInit, this keeps the context's lookup state when it is already set up
+// for the same image, so the context must have been initialized before.
+bool FIRCLSCompactUnwindInitWithImageInfo(FIRCLSCompactUnwindContext* context,
+                                          const FIRCLSCompactUnwindImageInfo* info,
+                                          const void* unwindInfo,
+                                          const void* ehFrame,
+                                          uintptr_t loadAddress);
 void* FIRCLSCompactUnwindGetIndexData(FIRCLSCompactUnwindContext* context);
 void* FIRCLSCompactUnwindGetSecondLevelData(FIRCLSCompactUnwindContext* context);
-bool FIRCLSCompactUnwindFindFirstLevelIndex(FIRCLSCompactUnwindContext* context,
-                                            uintptr_t pc,
-                                            uint32_t* index);
 
 bool FIRCLSCompactUnwindDwarfFrame(FIRCLSCompactUnwindContext* context,
                                    uintptr_t dwarfOffset,
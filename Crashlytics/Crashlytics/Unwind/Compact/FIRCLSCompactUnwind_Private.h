@@ -19,6 +19,7 @@
 #include <mach-o/compact_unwind_encoding.h>
 #pragma pack(pop)
 
+bool FIRCLSCompactUnwindLookupFirstLevel(FIRCLSCompactUnwindContext* context, uintptr_t address);
 bool FIRCLSCompactUnwindLookup(FIRCLSCompactUnwindContext* context,
                                uintptr_t pc,
                                FIRCLSCompactUnwindResult* result);
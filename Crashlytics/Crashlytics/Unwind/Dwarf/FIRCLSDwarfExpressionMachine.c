@@ -20,6 +20,8 @@
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSUtility.h"
 #include "Crashlytics/third_party/libunwind/dwarf.h"
 
+#include <string.h>
+
 #if CLS_DWARF_UNWINDING_SUPPORTED
 
 static bool FIRCLSDwarfExpressionMachineExecute_bregN(FIRCLSDwarfExpressionMachine *machine,
@@ -21,6 +21,7 @@
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSUtility.h"
 #include "Crashlytics/third_party/libunwind/dwarf.h"
 
+#include <stdatomic.h>
 #include <string.h>
 
 #if CLS_DWARF_UNWINDING_SUPPORTED
@@ -674,42 +675,129 @@ bool FIRCLSDwarfInstructionsEnumerate(DWARFInstructions* instructions,
   return true;
 }
 
-bool FIRCLSDwarfUnwindComputeRegisters(FIRCLSDwarfCFIRecord* record,
-                                       FIRCLSThreadContext* registers) {
-  if (!record || !registers) {
+#pragma mark - Unwind Cache
+static FIRCLSDwarfUnwindCacheEntry* FIRCLSDwarfUnwindCacheAcquireEntry(
+    FIRCLSDwarfUnwindCache* cache,
+    uintptr_t pc) {
+  if (!cache) {
+    return NULL;
+  }
+
+  FIRCLSDwarfUnwindCacheEntry* entry = &cache->entries[pc % CLS_DWARF_UNWIND_CACHE_ENTRY_COUNT];
+
+  // Never wait for another thread here. This can run in a signal handler that interrupted the
+  // thread holding the entry.
+  if (atomic_exchange(&entry->busy, true)) {
+    return NULL;
+  }
+
+  return entry;
+}
+
+static void FIRCLSDwarfUnwindCacheReleaseEntry(FIRCLSDwarfUnwindCacheEntry* entry) {
+  atomic_store(&entry->busy, false);
+}
+
+static bool FIRCLSDwarfUnwindCacheLookup(FIRCLSDwarfUnwindCache* cache,
+                                         const FIRCLSDwarfCFIRecord* record,
+                                         uintptr_t pc,
+                                         FIRCLSDwarfState* state) {
+  FIRCLSDwarfUnwindCacheEntry* entry = FIRCLSDwarfUnwindCacheAcquireEntry(cache, pc);
+  if (!entry) {
     return false;
   }
 
-  // We need to run the dwarf instructions to compute our register values.
-  // - initialize state
-  // - run the CIE instructions
-  // - run the FDE instructions
-  // - grab the values
+  // The row depends only on the CIE and FDE instruction streams and how far into the FDE the pc
+  // is, so those fully identify it.
+  bool found = entry->pc == pc && entry->cieInstructions == record->cie.instructions.data &&
+               entry->fdeInstructions == record->fde.instructions.data;
+  if (found) {
+    *state = entry->state;
+  }
 
-  FIRCLSDwarfState state;
+  FIRCLSDwarfUnwindCacheReleaseEntry(entry);
 
-  memset(&state, 0, sizeof(FIRCLSDwarfState));
+  return found;
+}
+
+static void FIRCLSDwarfUnwindCacheStore(FIRCLSDwarfUnwindCache* cache,
+                                        const FIRCLSDwarfCFIRecord* record,
+                                        uintptr_t pc,
+                                        const FIRCLSDwarfState* state) {
+  FIRCLSDwarfUnwindCacheEntry* entry = FIRCLSDwarfUnwindCacheAcquireEntry(cache, pc);
+  if (!entry) {
+    return;
+  }
+
+  entry->pc = pc;
+  entry->cieInstructions = record->cie.instructions.data;
+  entry->fdeInstructions = record->fde.instructions.data;
+  entry->state = *state;
+
+  FIRCLSDwarfUnwindCacheReleaseEntry(entry);
+}
+
+#pragma mark - Unwinding
+bool FIRCLSDwarfUnwindComputeRegisters(FIRCLSDwarfCFIRecord* record,
+                                       FIRCLSThreadContext* registers) {
+  return FIRCLSDwarfUnwindComputeRegistersWithCache(record, registers, NULL);
+}
+
+static bool FIRCLSDwarfUnwindComputeState(FIRCLSDwarfCFIRecord* record,
+                                          uintptr_t pc,
+                                          FIRCLSDwarfState* state) {
+  memset(state, 0, sizeof(FIRCLSDwarfState));
 
   // We need to run all the instructions in the CIE record. So, pass in a large value for the pc
   // offset so we don't stop early.
-  if (!FIRCLSDwarfInstructionsEnumerate(&record->cie.instructions, &record->cie, &state,
+  if (!FIRCLSDwarfInstructionsEnumerate(&record->cie.instructions, &record->cie, state,
                                         INTPTR_MAX)) {
     FIRCLSSDKLog("Error: Unable to run CIE instructions\n");
     return false;
   }
 
-  intptr_t pcOffset = FIRCLSThreadContextGetPC(registers) - record->fde.startAddress;
+  intptr_t pcOffset = pc - record->fde.startAddress;
   if (pcOffset < 0) {
     FIRCLSSDKLog("Error: The FDE pcOffset value cannot be negative\n");
     return false;
   }
 
-  if (!FIRCLSDwarfInstructionsEnumerate(&record->fde.instructions, &record->cie, &state,
+  if (!FIRCLSDwarfInstructionsEnumerate(&record->fde.instructions, &record->cie, state,
                                         pcOffset)) {
     FIRCLSSDKLog("Error: Unable to run FDE instructions\n");
     return false;
   }
 
+  return true;
+}
+
+bool FIRCLSDwarfUnwindComputeRegistersWithCache(FIRCLSDwarfCFIRecord* record,
+                                                FIRCLSThreadContext* registers,
+                                                FIRCLSDwarfUnwindCache* cache) {
+  if (!record || !registers) {
+    return false;
+  }
+
+  // We need to run the dwarf instructions to compute our register values.
+  // - initialize state
+  // - run the CIE instructions
+  // - run the FDE instructions
+  // - grab the values
+  //
+  // The resulting state only depends on the record and the pc, so it can be reused for frames
+  // that share a return address.
+
+  FIRCLSDwarfState state;
+  uintptr_t pc = FIRCLSThreadContextGetPC(registers);
+
+  if (!FIRCLSDwarfUnwindCacheLookup(cache, record, pc, &state)) {
+    if (!FIRCLSDwarfUnwindComputeState(record, pc, &state)) {
+      return false;
+    }
+
+    FIRCLSDwarfUnwindCacheStore(cache, record, pc, &state);
+  }
+
   uintptr_t cfaRegister = 0;
 
   if (!FIRCLSDwarfGetCFA(&state, registers, &cfaRegister)) {
@@ -83,6 +83,26 @@ typedef struct {
   FIRCLSDwarfRegister registers[CLS_DWARF_MAX_REGISTER_NUM + 1];
 } FIRCLSDwarfState;
 
+// When capturing all threads, most of them are parked at the same handful of return addresses. The
+// unwind cache remembers the interpreted CFI row for recently seen PCs so that those frames skip
+// running the CIE and FDE instructions again. It is direct-mapped, and lives in the crash context
+// so it needs no allocation at crash time.
+#define CLS_DWARF_UNWIND_CACHE_ENTRY_COUNT (32)
+
+typedef struct {
+  // Set while an entry is being read or written. A thread that finds it set treats the entry as a
+  // miss rather than waiting, which keeps the cache async-signal safe.
+  _Atomic(bool) volatile busy;
+  uintptr_t pc;
+  const void* cieInstructions;
+  const void* fdeInstructions;
+  FIRCLSDwarfState state;
+} FIRCLSDwarfUnwindCacheEntry;
+
+typedef struct {
+  FIRCLSDwarfUnwindCacheEntry entries[CLS_DWARF_UNWIND_CACHE_ENTRY_COUNT];
+} FIRCLSDwarfUnwindCache;
+
 __BEGIN_DECLS
 
 #pragma mark - Parsing
@@ -107,6 +127,9 @@ bool FIRCLSDwarfInstructionsEnumerate(DWARFInstructions* instructions,
                                       intptr_t pcOffset);
 bool FIRCLSDwarfUnwindComputeRegisters(FIRCLSDwarfCFIRecord* record,
                                        FIRCLSThreadContext* registers);
+bool FIRCLSDwarfUnwindComputeRegistersWithCache(FIRCLSDwarfCFIRecord* record,
+                                                FIRCLSThreadContext* registers,
+                                                FIRCLSDwarfUnwindCache* cache);
 bool FIRCLSDwarfUnwindAssignRegisters(const FIRCLSDwarfState* state,
                                       const FIRCLSThreadContext* registers,
                                       uintptr_t cfaRegister,
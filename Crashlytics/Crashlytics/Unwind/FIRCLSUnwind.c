@@ -244,12 +244,21 @@ static bool FIRCLSUnwindWithCompactUnwindInfo(FIRCLSUnwindContext* context) {
     return false;
   }
 
-  if (!FIRCLSCompactUnwindInit(&context->compactUnwindState, image.unwindInfo, image.ehFrame,
-                               (uintptr_t)image.baseAddress)) {
+  // The image's unwind header was read when it was loaded. This also lets consecutive frames in the
+  // same image reuse the previous lookup.
+  if (!FIRCLSCompactUnwindInitWithImageInfo(&context->compactUnwindState, &image.unwindImageInfo,
+                                            image.unwindInfo, image.ehFrame,
+                                            (uintptr_t)image.baseAddress)) {
     FIRCLSSDKLogError("Unable to read unwind info\n");
     return false;
   }
 
+#if CLS_DWARF_UNWINDING_SUPPORTED
+  if (FIRCLSIsValidPointer(_firclsContext.writable)) {
+    context->compactUnwindState.dwarfUnwindCache = &_firclsContext.writable->dwarfUnwindCache;
+  }
+#endif
+
   // this function will actually attempt to find compact unwind info for the current PC,
   // and use it to mutate the context register state
   return FIRCLSCompactUnwindLookupAndCompute(&context->compactUnwindState, &context->registers);
@@ -21,6 +21,8 @@
 #include "Crashlytics/Crashlytics/Unwind/FIRCLSUnwind_arch.h"
 #include "Crashlytics/Crashlytics/Helpers/FIRCLSUtility.h"
 
+#include <string.h>
+
 #if CLS_CPU_X86
 
 static bool FIRCLSCompactUnwindBPFrame(compact_unwind_encoding_t encoding,
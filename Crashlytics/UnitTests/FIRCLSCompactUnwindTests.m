@@ -155,6 +155,42 @@
 }
 #endif
 
+- (void)testLookupFirstLevelFindsEnclosingIndexEntry {
+  // A synthetic __unwind_info section: a header followed by a first-level index whose final entry
+  // only marks the end of the last range.
+  struct {
+    struct unwind_info_section_header header;
+    struct unwind_info_section_header_index_entry entries[9];
+  } unwindInfo;
+
+  memset(&unwindInfo, 0, sizeof(unwindInfo));
+  unwindInfo.header.version = UNWIND_SECTION_VERSION;
+  unwindInfo.header.indexSectionOffset = sizeof(struct unwind_info_section_header);
+  unwindInfo.header.indexCount = 9;
+  for (uint32_t i = 0; i < 9; ++i) {
+    unwindInfo.entries[i].functionOffset = 0x1000 * (i + 1);
+    unwindInfo.entries[i].secondLevelPagesSectionOffset = i;
+  }
+
+  FIRCLSCompactUnwindContext context;
+  const uintptr_t loadAddress = 0x100000000;
+  XCTAssertTrue(FIRCLSCompactUnwindInit(&context, &unwindInfo, NULL, loadAddress));
+
+  XCTAssertFalse(FIRCLSCompactUnwindLookupFirstLevel(&context, loadAddress + 0xfff));
+  XCTAssertFalse(FIRCLSCompactUnwindLookupFirstLevel(&context, loadAddress + 0x9000));
+
+  // Go backwards and revisit each range, so lookups both miss and hit the previous entry.
+  for (int i = 7; i >= 0; --i) {
+    uintptr_t start = loadAddress + 0x1000 * (i + 1);
+    XCTAssertTrue(FIRCLSCompactUnwindLookupFirstLevel(&context, start + 0xfff));
+    XCTAssertEqual(context.indexHeader.secondLevelPagesSectionOffset, i);
+    XCTAssertEqual(context.firstLevelNextFunctionOffset, 0x1000 * (i + 2));
+
+    XCTAssertTrue(FIRCLSCompactUnwindLookupFirstLevel(&context, start));
+    XCTAssertEqual(context.indexHeader.secondLevelPagesSectionOffset, i);
+  }
+}
+
 #if CLS_CPU_X86_64
 - (void)testComputeDirectStackSize {
   const compact_unwind_encoding_t encoding = 0x20a1860;
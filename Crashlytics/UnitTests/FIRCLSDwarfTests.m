@@ -166,6 +166,51 @@
   XCTAssertEqual(FIRCLSDwarfUnwindGetRegisterValue(&outputRegisters, CLS_DWARF_REG_RETURN), 777);
 }
 
+- (void)testComputeRegistersWithCacheReusesRows {
+  // CFA = SP + 2 words, with the return address saved one word below it.
+  const uint8_t cieInstructions[] = {DW_CFA_def_cfa, CLS_DWARF_REG_SP, 2 * sizeof(uintptr_t),
+                                     DW_CFA_offset | CLS_DWARF_REG_RETURN, 1};
+  const uint8_t fdeInstructions[] = {DW_CFA_nop};
+
+  FIRCLSDwarfCFIRecord record;
+  memset(&record, 0, sizeof(FIRCLSDwarfCFIRecord));
+  record.cie.codeAlignFactor = 1;
+  record.cie.dataAlignFactor = -(int64_t)sizeof(uintptr_t);
+  record.cie.returnAddressRegister = CLS_DWARF_REG_RETURN;
+  record.cie.instructions.data = cieInstructions;
+  record.cie.instructions.length = sizeof(cieInstructions);
+  record.fde.startAddress = 0x1000;
+  record.fde.rangeSize = 0x100;
+  record.fde.instructions.data = fdeInstructions;
+  record.fde.instructions.length = sizeof(fdeInstructions);
+
+  FIRCLSDwarfUnwindCache* cache = calloc(1, sizeof(FIRCLSDwarfUnwindCache));
+  const uintptr_t pc = 0x1010;
+
+  // Unwind two different stacks stopped at the same pc. The second one is computed from the cached
+  // row, and must still be applied against its own registers.
+  uintptr_t stacks[2][2] = {{0, 0x2000}, {0, 0x3000}};
+  for (int i = 0; i < 2; ++i) {
+    FIRCLSThreadContext registers;
+    memset(&registers, 0, sizeof(FIRCLSThreadContext));
+    FIRCLSThreadContextSetPC(&registers, pc);
+    FIRCLSThreadContextSetStackPointer(&registers, (uintptr_t)stacks[i]);
+
+    XCTAssertTrue(FIRCLSDwarfUnwindComputeRegistersWithCache(&record, &registers, cache));
+
+    XCTAssertEqual(FIRCLSDwarfUnwindGetRegisterValue(&registers, CLS_DWARF_REG_RETURN),
+                   stacks[i][1]);
+    XCTAssertEqual(FIRCLSDwarfUnwindGetRegisterValue(&registers, CLS_DWARF_REG_SP),
+                   (uintptr_t)stacks[i] + 2 * sizeof(uintptr_t));
+
+    FIRCLSDwarfUnwindCacheEntry* entry = &cache->entries[pc % CLS_DWARF_UNWIND_CACHE_ENTRY_COUNT];
+    XCTAssertEqual(entry->pc, pc);
+    XCTAssertEqual(entry->fdeInstructions, (const void*)fdeInstructions);
+  }
+
+  free(cache);
+}
+
 #endif
 
 @end
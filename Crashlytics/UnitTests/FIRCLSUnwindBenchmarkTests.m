@@ -0,0 +1,318 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import <XCTest/XCTest.h>
+
+#include "Crashlytics/third_party/libunwind/dwarf.h"
+
+#include "Crashlytics/Crashlytics/Components/FIRCLSContext.h"
+#include "Crashlytics/Crashlytics/Components/FIRCLSGlobals.h"
+#include "Crashlytics/Crashlytics/Helpers/FIRCLSFeatures.h"
+#include "Crashlytics/Crashlytics/Unwind/FIRCLSUnwind_arch.h"
+
+#if CLS_COMPACT_UNWINDING_SUPPORTED
+#include "Crashlytics/Crashlytics/Unwind/Compact/FIRCLSCompactUnwind_Private.h"
+#endif
+#if CLS_DWARF_UNWINDING_SUPPORTED
+#include "Crashlytics/Crashlytics/Unwind/Dwarf/FIRCLSDwarfUnwind.h"
+#endif
+
+// These tests measure the unwinders against synthetic __eh_frame and __unwind_info sections, so the
+// numbers depend only on the parsing and lookup code, and not on the binaries of a particular OS.
+// Each measured block unwinds enough frames that a single run is meaningful.
+//
+// Crashlytics/UnitTests/HostUnwind runs the same measurements, along with correctness checks,
+// against the same sections on Linux, where there is no XCTest.
+#define FIRCLSUnwindBenchmarkFrameCount (10000)
+
+@interface FIRCLSUnwindBenchmarkTests : XCTestCase
+
+@end
+
+@implementation FIRCLSUnwindBenchmarkTests
+
+- (void)setUp {
+  [super setUp];
+
+  _firclsContext.readonly = malloc(sizeof(FIRCLSReadOnlyContext));
+  _firclsContext.readonly->logPath = "/tmp/test.log";
+}
+
+- (void)tearDown {
+  free(_firclsContext.readonly);
+  _firclsContext.readonly = NULL;
+
+  [super tearDown];
+}
+
+#pragma mark - Synthetic Sections
+
+- (void)appendBytes:(const uint8_t*)bytes length:(size_t)length toData:(NSMutableData*)data {
+  [data appendBytes:bytes length:length];
+}
+
+- (void)appendUInt32:(uint32_t)value toData:(NSMutableData*)data {
+  [data appendBytes:&value length:sizeof(value)];
+}
+
+- (void)appendPointer:(uintptr_t)value toData:(NSMutableData*)data {
+  [data appendBytes:&value length:sizeof(value)];
+}
+
+// Records are padded with DW_CFA_nop, so their lengths stay pointer-aligned like a real __eh_frame.
+- (void)padRecordStartingAt:(NSUInteger)start inData:(NSMutableData*)data {
+  const uint8_t nop = DW_CFA_nop;
+  while ((data.length - start) % sizeof(uintptr_t) != 0) {
+    [data appendBytes:&nop length:1];
+  }
+
+  uint32_t length = (uint32_t)(data.length - start - sizeof(uint32_t));
+  [data replaceBytesInRange:NSMakeRange(start, sizeof(uint32_t)) withBytes:&length];
+}
+
+#if CLS_DWARF_UNWINDING_SUPPORTED
+// Builds an __eh_frame with one CIE and one FDE, and returns the FDE's offset. The CIE's initial
+// instructions describe a frame with CFA = SP + 2 words and the return address just below the CFA.
+- (NSUInteger)appendEHFrameToData:(NSMutableData*)data
+                  fdeInstructions:(NSData*)fdeInstructions
+                     startAddress:(uintptr_t)startAddress
+                        rangeSize:(uintptr_t)rangeSize {
+  const NSUInteger cieStart = data.length;
+  const uint8_t cie[] = {
+      1,                         // version
+      'z', 'R', 0,               // augmentation
+      1,                         // code alignment factor
+      0x80 - sizeof(uintptr_t),  // data alignment factor, as a SLEB128
+      CLS_DWARF_REG_RETURN,      // return address register
+      1,                         // augmentation data length
+      DW_EH_PE_absptr,           // FDE pointer encoding
+      DW_CFA_def_cfa, CLS_DWARF_REG_SP, 2 * sizeof(uintptr_t),
+      DW_CFA_offset | CLS_DWARF_REG_RETURN, 1,
+  };
+
+  [self appendUInt32:0 toData:data];
+  [self appendUInt32:DWARF_CIE_ID_CIE_FLAG toData:data];
+  [self appendBytes:cie length:sizeof(cie) toData:data];
+  [self padRecordStartingAt:cieStart inData:data];
+
+  const NSUInteger fdeStart = data.length;
+  const uint8_t noAugmentationData = 0;
+
+  [self appendUInt32:0 toData:data];
+  [self appendUInt32:(uint32_t)(fdeStart + sizeof(uint32_t) - cieStart) toData:data];
+  [self appendPointer:startAddress toData:data];
+  [self appendPointer:rangeSize toData:data];
+  [self appendBytes:&noAugmentationData length:1 toData:data];
+  [data appendData:fdeInstructions];
+  [self padRecordStartingAt:fdeStart inData:data];
+
+  return fdeStart;
+}
+
+- (void)measureDwarfUnwindWithFDEInstructions:(NSData*)fdeInstructions
+                                  pcRangeSize:(uintptr_t)rangeSize
+                                        cache:(FIRCLSDwarfUnwindCache*)cache {
+  const uintptr_t startAddress = 0x100000;
+  NSMutableData* ehFrame = [NSMutableData data];
+  NSUInteger fdeOffset = [self appendEHFrameToData:ehFrame
+                                   fdeInstructions:fdeInstructions
+                                      startAddress:startAddress
+                                         rangeSize:rangeSize];
+
+  // A recorded stack: the return address sits one word below the CFA.
+  uintptr_t stack[2] = {0, 0x5000};
+  const uintptr_t pc = startAddress + rangeSize - 1;
+
+  FIRCLSDwarfCFIRecord record;
+  XCTAssertTrue(FIRCLSDwarfParseCFIFromFDERecordOffset(&record, ehFrame.bytes, fdeOffset));
+
+  FIRCLSThreadContext registers;
+  memset(&registers, 0, sizeof(FIRCLSThreadContext));
+  FIRCLSThreadContextSetPC(&registers, pc);
+  FIRCLSThreadContextSetStackPointer(&registers, (uintptr_t)stack);
+  XCTAssertTrue(FIRCLSDwarfUnwindComputeRegistersWithCache(&record, &registers, cache));
+  XCTAssertEqual(FIRCLSDwarfUnwindGetRegisterValue(&registers, CLS_DWARF_REG_RETURN), stack[1]);
+
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < FIRCLSUnwindBenchmarkFrameCount; ++i) {
+      FIRCLSDwarfCFIRecord frameRecord;
+      FIRCLSDwarfParseCFIFromFDERecordOffset(&frameRecord, ehFrame.bytes, fdeOffset);
+
+      FIRCLSThreadContext frameRegisters;
+      memset(&frameRegisters, 0, sizeof(FIRCLSThreadContext));
+      FIRCLSThreadContextSetPC(&frameRegisters, pc);
+      FIRCLSThreadContextSetStackPointer(&frameRegisters, (uintptr_t)stack);
+      FIRCLSDwarfUnwindComputeRegistersWithCache(&frameRecord, &frameRegisters, cache);
+    }
+  }];
+}
+
+#pragma mark - DWARF
+
+// Per-frame latency of the common case: a short FDE that only adjusts the CFA once.
+- (void)testDwarfUnwindFramePerformance {
+  const uint8_t instructions[] = {DW_CFA_advance_loc | 4, DW_CFA_def_cfa_offset,
+                                  2 * sizeof(uintptr_t)};
+
+  [self measureDwarfUnwindWithFDEInstructions:[NSData dataWithBytes:instructions
+                                                             length:sizeof(instructions)]
+                                  pcRangeSize:0x40
+                                        cache:NULL];
+}
+
+- (void)testDwarfUnwindFrameWithCachePerformance {
+  const uint8_t instructions[] = {DW_CFA_advance_loc | 4, DW_CFA_def_cfa_offset,
+                                  2 * sizeof(uintptr_t)};
+  FIRCLSDwarfUnwindCache* cache = calloc(1, sizeof(FIRCLSDwarfUnwindCache));
+
+  [self measureDwarfUnwindWithFDEInstructions:[NSData dataWithBytes:instructions
+                                                             length:sizeof(instructions)]
+                                  pcRangeSize:0x40
+                                        cache:cache];
+
+  free(cache);
+}
+
+// CFI interpretation throughput: a long function whose FDE defines a new row for every byte, with
+// the pc at its very end so that every instruction is run.
+- (void)testDwarfCFIInterpretationPerformance {
+  const NSUInteger rowCount = 4096;
+  NSMutableData* instructions = [NSMutableData data];
+  for (NSUInteger i = 0; i < rowCount; ++i) {
+    const uint8_t row[] = {DW_CFA_advance_loc | 1, DW_CFA_def_cfa_offset, 2 * sizeof(uintptr_t)};
+    [instructions appendBytes:row length:sizeof(row)];
+  }
+
+  [self measureDwarfUnwindWithFDEInstructions:instructions pcRangeSize:rowCount + 1 cache:NULL];
+}
+
+// A CFA computed by the expression machine, as in hand-written assembly and signal trampolines.
+- (void)testDwarfCFAExpressionPerformance {
+  const uint8_t instructions[] = {
+      DW_CFA_def_cfa_expression, 2, DW_OP_breg0 + CLS_DWARF_REG_SP, 2 * sizeof(uintptr_t),
+  };
+
+  [self measureDwarfUnwindWithFDEInstructions:[NSData dataWithBytes:instructions
+                                                             length:sizeof(instructions)]
+                                  pcRangeSize:0x40
+                                        cache:NULL];
+}
+#endif
+
+#pragma mark - Compact Unwind
+
+#if CLS_COMPACT_UNWINDING_SUPPORTED
+// Builds an __unwind_info with pageCount compressed second-level pages, each describing
+// functionsPerPage functions of functionSize bytes. The image's text starts at 0x1000.
+- (NSData*)unwindInfoWithPageCount:(uint32_t)pageCount
+                  functionsPerPage:(uint32_t)functionsPerPage
+                      functionSize:(uint32_t)functionSize {
+  // Any non-zero encoding will do, since only the lookup is measured.
+  const compact_unwind_encoding_t commonEncoding = 0x01000000;
+  const uint32_t pageSize = functionSize * functionsPerPage;
+
+  struct unwind_info_section_header header;
+  memset(&header, 0, sizeof(header));
+  header.version = UNWIND_SECTION_VERSION;
+  header.commonEncodingsArraySectionOffset = sizeof(header);
+  header.commonEncodingsArrayCount = 1;
+  header.indexSectionOffset = sizeof(header) + sizeof(commonEncoding);
+  header.indexCount = pageCount + 1;
+
+  const uint32_t pagesOffset =
+      header.indexSectionOffset +
+      header.indexCount * sizeof(struct unwind_info_section_header_index_entry);
+  const uint32_t pageLength =
+      sizeof(struct unwind_info_compressed_second_level_page_header) +
+      functionsPerPage * sizeof(uint32_t);
+
+  NSMutableData* data = [NSMutableData data];
+  [data appendBytes:&header length:sizeof(header)];
+  [data appendBytes:&commonEncoding length:sizeof(commonEncoding)];
+
+  for (uint32_t i = 0; i <= pageCount; ++i) {
+    struct unwind_info_section_header_index_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.functionOffset = 0x1000 + i * pageSize;
+    entry.secondLevelPagesSectionOffset = i < pageCount ? pagesOffset + i * pageLength : 0;
+    [data appendBytes:&entry length:sizeof(entry)];
+  }
+
+  for (uint32_t i = 0; i < pageCount; ++i) {
+    struct unwind_info_compressed_second_level_page_header page;
+    memset(&page, 0, sizeof(page));
+    page.kind = UNWIND_SECOND_LEVEL_COMPRESSED;
+    page.entryPageOffset = sizeof(page);
+    page.entryCount = functionsPerPage;
+    page.encodingsPageOffset = pageLength;
+    [data appendBytes:&page length:sizeof(page)];
+
+    // Every entry uses common encoding 0, so its upper byte is zero.
+    for (uint32_t j = 0; j < functionsPerPage; ++j) {
+      [self appendUInt32:j * functionSize toData:data];
+    }
+  }
+
+  return data;
+}
+
+- (void)testCompactUnwindLookupPerformance {
+  const uint32_t pageCount = 1024;
+  const uint32_t functionsPerPage = 256;
+  const uint32_t functionSize = 0x40;
+  const uintptr_t loadAddress = 0x100000000;
+  NSData* unwindInfo = [self unwindInfoWithPageCount:pageCount
+                                    functionsPerPage:functionsPerPage
+                                        functionSize:functionSize];
+
+  // Sample pcs from all over the image, so that consecutive lookups rarely share a first-level
+  // entry, like frames that cross between unrelated libraries.
+  uintptr_t* pcs = malloc(FIRCLSUnwindBenchmarkFrameCount * sizeof(uintptr_t));
+  uint32_t seed = 1;
+  for (NSUInteger i = 0; i < FIRCLSUnwindBenchmarkFrameCount; ++i) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t function = (seed >> 8) % (pageCount * functionsPerPage);
+    pcs[i] = loadAddress + 0x1000 + function * functionSize + 0x10;
+  }
+
+  FIRCLSCompactUnwindImageInfo imageInfo;
+  XCTAssertTrue(FIRCLSCompactUnwindImageInfoInit(&imageInfo, unwindInfo.bytes));
+
+  FIRCLSCompactUnwindContext context;
+  FIRCLSCompactUnwindResult result;
+  memset(&context, 0, sizeof(FIRCLSCompactUnwindContext));
+  XCTAssertTrue(FIRCLSCompactUnwindInitWithImageInfo(&context, &imageInfo, unwindInfo.bytes, NULL,
+                                                     loadAddress));
+  XCTAssertTrue(FIRCLSCompactUnwindLookup(&context, pcs[0], &result));
+  XCTAssertEqual(result.functionStart, pcs[0] - 0x10);
+  XCTAssertEqual(result.functionEnd, pcs[0] - 0x10 + functionSize);
+
+  [self measureBlock:^{
+    FIRCLSCompactUnwindContext frameContext;
+    FIRCLSCompactUnwindResult frameResult;
+    memset(&frameContext, 0, sizeof(FIRCLSCompactUnwindContext));
+
+    for (NSUInteger i = 0; i < FIRCLSUnwindBenchmarkFrameCount; ++i) {
+      FIRCLSCompactUnwindInitWithImageInfo(&frameContext, &imageInfo, unwindInfo.bytes, NULL,
+                                           loadAddress);
+      FIRCLSCompactUnwindLookup(&frameContext, pcs[i], &frameResult);
+    }
+  }];
+
+  free(pcs);
+}
+#endif
+
+@end
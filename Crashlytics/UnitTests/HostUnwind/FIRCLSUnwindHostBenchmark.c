@@ -0,0 +1,187 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Times the DWARF and compact unwinders against the synthetic sections that
+// FIRCLSUnwindBenchmarkTests.m measures under XCTest, so that changes to them can be measured on a
+// host without the Apple SDK. Prints the best of several runs, in nanoseconds per frame.
+//
+// Usage: FIRCLSUnwindHostBenchmark [frames per run]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Crashlytics/Crashlytics/Helpers/FIRCLSThreadState.h"
+#include "Crashlytics/Crashlytics/Unwind/Compact/FIRCLSCompactUnwind_Private.h"
+#include "Crashlytics/Crashlytics/Unwind/Dwarf/FIRCLSDwarfUnwind.h"
+#include "Crashlytics/UnitTests/HostUnwind/FIRCLSUnwindSyntheticSections.h"
+#include "Crashlytics/third_party/libunwind/dwarf.h"
+
+#define FIRCLSHostBenchmarkRunCount (10)
+
+static size_t FIRCLSHostBenchmarkFrameCount = 10000;
+
+static uint64_t FIRCLSHostBenchmarkNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+static void FIRCLSHostBenchmarkReport(const char* name, uint64_t bestRunNanoseconds) {
+  printf("%-32s %10.1f ns/frame\n", name,
+         (double)bestRunNanoseconds / (double)FIRCLSHostBenchmarkFrameCount);
+}
+
+#pragma mark - DWARF
+
+static void FIRCLSHostBenchmarkDwarfUnwind(const char* name,
+                                           const uint8_t* instructions,
+                                           size_t instructionsLength,
+                                           uintptr_t rangeSize,
+                                           FIRCLSDwarfUnwindCache* cache) {
+  const uintptr_t startAddress = 0x100000;
+  FIRCLSSyntheticSection ehFrame = {0};
+  const size_t fdeOffset = FIRCLSSyntheticSectionAppendEHFrame(&ehFrame, instructions,
+                                                               instructionsLength, startAddress,
+                                                               rangeSize);
+
+  uintptr_t stack[2] = {0, 0x5000};
+  const uintptr_t pc = startAddress + rangeSize - 1;
+
+  uint64_t best = UINT64_MAX;
+  for (int run = 0; run < FIRCLSHostBenchmarkRunCount; ++run) {
+    const uint64_t start = FIRCLSHostBenchmarkNow();
+
+    for (size_t i = 0; i < FIRCLSHostBenchmarkFrameCount; ++i) {
+      FIRCLSDwarfCFIRecord record;
+      FIRCLSDwarfParseCFIFromFDERecordOffset(&record, ehFrame.bytes, fdeOffset);
+
+      FIRCLSThreadContext registers;
+      memset(&registers, 0, sizeof(FIRCLSThreadContext));
+      FIRCLSThreadContextSetPC(&registers, pc);
+      FIRCLSThreadContextSetStackPointer(&registers, (uintptr_t)stack);
+      if (!FIRCLSDwarfUnwindComputeRegistersWithCache(&record, &registers, cache)) {
+        fprintf(stderr, "%s: unwind failed\n", name);
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    const uint64_t elapsed = FIRCLSHostBenchmarkNow() - start;
+    if (elapsed < best) {
+      best = elapsed;
+    }
+  }
+
+  FIRCLSHostBenchmarkReport(name, best);
+  FIRCLSSyntheticSectionFree(&ehFrame);
+}
+
+static void FIRCLSHostBenchmarkDwarf(void) {
+  const uint8_t shortInstructions[] = {DW_CFA_advance_loc | 4, DW_CFA_def_cfa_offset,
+                                       2 * sizeof(uintptr_t)};
+  FIRCLSHostBenchmarkDwarfUnwind("DwarfUnwindFrame", shortInstructions, sizeof(shortInstructions),
+                                 0x40, NULL);
+
+  FIRCLSDwarfUnwindCache* cache = calloc(1, sizeof(FIRCLSDwarfUnwindCache));
+  FIRCLSHostBenchmarkDwarfUnwind("DwarfUnwindFrameWithCache", shortInstructions,
+                                 sizeof(shortInstructions), 0x40, cache);
+  free(cache);
+
+  const size_t rowCount = 4096;
+  const uint8_t row[] = {DW_CFA_advance_loc | 1, DW_CFA_def_cfa_offset, 2 * sizeof(uintptr_t)};
+  uint8_t* longInstructions = malloc(rowCount * sizeof(row));
+  for (size_t i = 0; i < rowCount; ++i) {
+    memcpy(longInstructions + i * sizeof(row), row, sizeof(row));
+  }
+  FIRCLSHostBenchmarkDwarfUnwind("DwarfCFIInterpretation", longInstructions,
+                                 rowCount * sizeof(row), rowCount + 1, NULL);
+  free(longInstructions);
+
+  const uint8_t expressionInstructions[] = {
+      DW_CFA_def_cfa_expression, 2, DW_OP_breg0 + CLS_DWARF_REG_SP, 2 * sizeof(uintptr_t),
+  };
+  FIRCLSHostBenchmarkDwarfUnwind("DwarfCFAExpression", expressionInstructions,
+                                 sizeof(expressionInstructions), 0x40, NULL);
+}
+
+#pragma mark - Compact Unwind
+
+static void FIRCLSHostBenchmarkCompactUnwindLookup(void) {
+  const uint32_t pageCount = 1024;
+  const uint32_t functionsPerPage = 256;
+  const uint32_t functionSize = 0x40;
+  const uintptr_t loadAddress = 0x100000000;
+  FIRCLSSyntheticSection unwindInfo = {0};
+  FIRCLSSyntheticSectionAppendUnwindInfo(&unwindInfo, pageCount, functionsPerPage, functionSize);
+
+  // Sample pcs from all over the image, so that consecutive lookups rarely share a first-level
+  // entry, like frames that cross between unrelated libraries.
+  uintptr_t* pcs = malloc(FIRCLSHostBenchmarkFrameCount * sizeof(uintptr_t));
+  uint32_t seed = 1;
+  for (size_t i = 0; i < FIRCLSHostBenchmarkFrameCount; ++i) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t function = (seed >> 8) % (pageCount * functionsPerPage);
+    pcs[i] = loadAddress + FIRCLSSyntheticUnwindInfoTextStart + function * functionSize + 0x10;
+  }
+
+  FIRCLSCompactUnwindImageInfo imageInfo;
+  if (!FIRCLSCompactUnwindImageInfoInit(&imageInfo, unwindInfo.bytes)) {
+    fprintf(stderr, "CompactUnwindLookup: invalid __unwind_info\n");
+    exit(EXIT_FAILURE);
+  }
+
+  uint64_t best = UINT64_MAX;
+  for (int run = 0; run < FIRCLSHostBenchmarkRunCount; ++run) {
+    const uint64_t start = FIRCLSHostBenchmarkNow();
+
+    FIRCLSCompactUnwindContext context;
+    FIRCLSCompactUnwindResult result;
+    memset(&context, 0, sizeof(FIRCLSCompactUnwindContext));
+
+    for (size_t i = 0; i < FIRCLSHostBenchmarkFrameCount; ++i) {
+      FIRCLSCompactUnwindInitWithImageInfo(&context, &imageInfo, unwindInfo.bytes, NULL,
+                                           loadAddress);
+      if (!FIRCLSCompactUnwindLookup(&context, pcs[i], &result)) {
+        fprintf(stderr, "CompactUnwindLookup: lookup failed\n");
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    const uint64_t elapsed = FIRCLSHostBenchmarkNow() - start;
+    if (elapsed < best) {
+      best = elapsed;
+    }
+  }
+
+  FIRCLSHostBenchmarkReport("CompactUnwindLookup", best);
+  free(pcs);
+  FIRCLSSyntheticSectionFree(&unwindInfo);
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    FIRCLSHostBenchmarkFrameCount = strtoul(argv[1], NULL, 10);
+    if (FIRCLSHostBenchmarkFrameCount == 0) {
+      fprintf(stderr, "usage: %s [frames per run]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  FIRCLSHostBenchmarkDwarf();
+  FIRCLSHostBenchmarkCompactUnwindLookup();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host definitions of the few SDK functions the unwinders call outside of the files the host
+// harness compiles. Their Apple versions live in Objective-C files or need the binary image list.
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "Crashlytics/Crashlytics/Helpers/FIRCLSInternalLogging.h"
+#include "Crashlytics/Crashlytics/Helpers/FIRCLSUtility.h"
+#include "Crashlytics/Crashlytics/Unwind/FIRCLSUnwind.h"
+
+// The harness only reads memory it owns, so there is no need for vm_read_overwrite's fault
+// protection.
+bool FIRCLSReadMemory(vm_address_t src, void* dest, size_t len) {
+  if (!FIRCLSIsValidPointer(src)) {
+    return false;
+  }
+
+  memcpy(dest, (const void*)src, len);
+
+  return true;
+}
+
+void FIRCLSSDKFileLog(FIRCLSInternalLogLevel level, const char* format, ...) {
+}
+
+// Stack scanning needs the binary image list to tell code from data, and there is none here.
+bool FIRCLSUnwindFirstExecutableAddress(vm_address_t start,
+                                        vm_address_t end,
+                                        vm_address_t* foundAddress) {
+  *foundAddress = 0;
+
+  return false;
+}
@@ -0,0 +1,206 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks the DWARF and compact unwinders against synthetic sections, on a host without the Apple
+// SDK. Exits with a non-zero status if any check fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Crashlytics/Crashlytics/Helpers/FIRCLSThreadState.h"
+#include "Crashlytics/Crashlytics/Unwind/Compact/FIRCLSCompactUnwind_Private.h"
+#include "Crashlytics/Crashlytics/Unwind/Dwarf/FIRCLSDwarfUnwind.h"
+#include "Crashlytics/Crashlytics/Unwind/FIRCLSUnwind_arch.h"
+#include "Crashlytics/UnitTests/HostUnwind/FIRCLSUnwindSyntheticSections.h"
+#include "Crashlytics/third_party/libunwind/dwarf.h"
+
+static int FIRCLSHostTestFailures = 0;
+
+#define FIRCLSHostCheck(condition)                                                  \
+  do {                                                                              \
+    if (!(condition)) {                                                             \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      ++FIRCLSHostTestFailures;                                                     \
+    }                                                                               \
+  } while (0)
+
+#pragma mark - DWARF
+
+static const uintptr_t FIRCLSHostTestStartAddress = 0x100000;
+
+// Unwinds one frame at the last pc of an FDE with the given instructions, from a recorded stack
+// whose return address sits one word below a CFA of SP + 2 words.
+static void FIRCLSHostTestDwarfUnwind(const uint8_t* instructions,
+                                      size_t instructionsLength,
+                                      uintptr_t rangeSize,
+                                      FIRCLSDwarfUnwindCache* cache) {
+  FIRCLSSyntheticSection ehFrame = {0};
+  const size_t fdeOffset = FIRCLSSyntheticSectionAppendEHFrame(
+      &ehFrame, instructions, instructionsLength, FIRCLSHostTestStartAddress, rangeSize);
+
+  uintptr_t stack[2] = {0, 0x5000};
+  const uintptr_t pc = FIRCLSHostTestStartAddress + rangeSize - 1;
+
+  FIRCLSDwarfCFIRecord record;
+  FIRCLSHostCheck(FIRCLSDwarfParseCFIFromFDERecordOffset(&record, ehFrame.bytes, fdeOffset));
+  FIRCLSHostCheck(record.fde.startAddress == FIRCLSHostTestStartAddress);
+  FIRCLSHostCheck(record.fde.rangeSize == rangeSize);
+
+  // Twice, so that a cache is checked on both its miss and its hit.
+  for (int i = 0; i < 2; ++i) {
+    FIRCLSThreadContext registers;
+    memset(&registers, 0, sizeof(FIRCLSThreadContext));
+    FIRCLSThreadContextSetPC(&registers, pc);
+    FIRCLSThreadContextSetStackPointer(&registers, (uintptr_t)stack);
+
+    FIRCLSHostCheck(FIRCLSDwarfUnwindComputeRegistersWithCache(&record, &registers, cache));
+    FIRCLSHostCheck(FIRCLSDwarfUnwindGetRegisterValue(&registers, CLS_DWARF_REG_RETURN) ==
+                    stack[1]);
+    FIRCLSHostCheck(FIRCLSThreadContextGetStackPointer(&registers) ==
+                    (uintptr_t)stack + 2 * sizeof(uintptr_t));
+  }
+
+  FIRCLSSyntheticSectionFree(&ehFrame);
+}
+
+static void FIRCLSHostTestDwarfShortFDE(void) {
+  const uint8_t instructions[] = {DW_CFA_advance_loc | 4, DW_CFA_def_cfa_offset,
+                                  2 * sizeof(uintptr_t)};
+
+  FIRCLSHostTestDwarfUnwind(instructions, sizeof(instructions), 0x40, NULL);
+
+  FIRCLSDwarfUnwindCache* cache = calloc(1, sizeof(FIRCLSDwarfUnwindCache));
+  FIRCLSHostTestDwarfUnwind(instructions, sizeof(instructions), 0x40, cache);
+  free(cache);
+}
+
+static void FIRCLSHostTestDwarfLongCFIProgram(void) {
+  const size_t rowCount = 4096;
+  const uint8_t row[] = {DW_CFA_advance_loc | 1, DW_CFA_def_cfa_offset, 2 * sizeof(uintptr_t)};
+  uint8_t* instructions = malloc(rowCount * sizeof(row));
+  for (size_t i = 0; i < rowCount; ++i) {
+    memcpy(instructions + i * sizeof(row), row, sizeof(row));
+  }
+
+  FIRCLSHostTestDwarfUnwind(instructions, rowCount * sizeof(row), rowCount + 1, NULL);
+
+  free(instructions);
+}
+
+static void FIRCLSHostTestDwarfCFAExpression(void) {
+  const uint8_t instructions[] = {
+      DW_CFA_def_cfa_expression, 2, DW_OP_breg0 + CLS_DWARF_REG_SP, 2 * sizeof(uintptr_t),
+  };
+
+  FIRCLSHostTestDwarfUnwind(instructions, sizeof(instructions), 0x40, NULL);
+}
+
+#pragma mark - Compact Unwind
+
+static const uint32_t FIRCLSHostTestPageCount = 64;
+static const uint32_t FIRCLSHostTestFunctionsPerPage = 32;
+static const uint32_t FIRCLSHostTestFunctionSize = 0x40;
+static const uintptr_t FIRCLSHostTestLoadAddress = 0x100000000;
+
+static void FIRCLSHostTestCompactUnwindLookup(void) {
+  FIRCLSSyntheticSection unwindInfo = {0};
+  FIRCLSSyntheticSectionAppendUnwindInfo(&unwindInfo, FIRCLSHostTestPageCount,
+                                         FIRCLSHostTestFunctionsPerPage,
+                                         FIRCLSHostTestFunctionSize);
+
+  FIRCLSCompactUnwindImageInfo imageInfo;
+  FIRCLSHostCheck(FIRCLSCompactUnwindImageInfoInit(&imageInfo, unwindInfo.bytes));
+
+  const uintptr_t textStart = FIRCLSHostTestLoadAddress + FIRCLSSyntheticUnwindInfoTextStart;
+  const uint32_t functionCount = FIRCLSHostTestPageCount * FIRCLSHostTestFunctionsPerPage;
+
+  // Every function, hit at its first byte, in its middle and at its last byte.
+  const uintptr_t offsets[] = {0, FIRCLSHostTestFunctionSize / 2, FIRCLSHostTestFunctionSize - 1};
+  for (uint32_t function = 0; function < functionCount; ++function) {
+    const uintptr_t functionStart = textStart + function * FIRCLSHostTestFunctionSize;
+
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+      FIRCLSCompactUnwindContext context;
+      FIRCLSCompactUnwindResult result;
+      memset(&context, 0, sizeof(FIRCLSCompactUnwindContext));
+      FIRCLSHostCheck(FIRCLSCompactUnwindInitWithImageInfo(&context, &imageInfo, unwindInfo.bytes,
+                                                           NULL, FIRCLSHostTestLoadAddress));
+      FIRCLSHostCheck(FIRCLSCompactUnwindLookup(&context, functionStart + offsets[i], &result));
+      FIRCLSHostCheck(result.functionStart == functionStart);
+      FIRCLSHostCheck(result.functionEnd == functionStart + FIRCLSHostTestFunctionSize);
+      FIRCLSHostCheck(result.encoding == 0x01000000);
+    }
+  }
+
+  // Outside of the image's text, on either side.
+  const uintptr_t outside[] = {textStart - 1,
+                               textStart + functionCount * FIRCLSHostTestFunctionSize};
+  for (size_t i = 0; i < sizeof(outside) / sizeof(outside[0]); ++i) {
+    FIRCLSCompactUnwindContext context;
+    FIRCLSCompactUnwindResult result;
+    memset(&context, 0, sizeof(FIRCLSCompactUnwindContext));
+    FIRCLSHostCheck(FIRCLSCompactUnwindInitWithImageInfo(&context, &imageInfo, unwindInfo.bytes,
+                                                         NULL, FIRCLSHostTestLoadAddress));
+    FIRCLSHostCheck(!FIRCLSCompactUnwindLookup(&context, outside[i], &result));
+  }
+
+  FIRCLSSyntheticSectionFree(&unwindInfo);
+}
+
+// The common encoding is an RBP frame, so a lookup followed by a compute pops one frame.
+static void FIRCLSHostTestCompactUnwindLookupAndCompute(void) {
+  FIRCLSSyntheticSection unwindInfo = {0};
+  FIRCLSSyntheticSectionAppendUnwindInfo(&unwindInfo, FIRCLSHostTestPageCount,
+                                         FIRCLSHostTestFunctionsPerPage,
+                                         FIRCLSHostTestFunctionSize);
+
+  FIRCLSCompactUnwindImageInfo imageInfo;
+  FIRCLSHostCheck(FIRCLSCompactUnwindImageInfoInit(&imageInfo, unwindInfo.bytes));
+
+  // The saved frame pointer, then the return address.
+  uintptr_t frame[2] = {0x7000, 0x6000};
+  FIRCLSThreadContext registers;
+  memset(&registers, 0, sizeof(FIRCLSThreadContext));
+  FIRCLSThreadContextSetPC(&registers, FIRCLSHostTestLoadAddress +
+                                           FIRCLSSyntheticUnwindInfoTextStart + 0x1234);
+  FIRCLSThreadContextSetFramePointer(&registers, (uintptr_t)frame);
+
+  FIRCLSCompactUnwindContext context;
+  memset(&context, 0, sizeof(FIRCLSCompactUnwindContext));
+  FIRCLSHostCheck(FIRCLSCompactUnwindInitWithImageInfo(&context, &imageInfo, unwindInfo.bytes,
+                                                       NULL, FIRCLSHostTestLoadAddress));
+  FIRCLSHostCheck(FIRCLSCompactUnwindLookupAndCompute(&context, &registers));
+  FIRCLSHostCheck(FIRCLSThreadContextGetPC(&registers) == frame[1]);
+  FIRCLSHostCheck(FIRCLSThreadContextGetFramePointer(&registers) == frame[0]);
+  FIRCLSHostCheck(FIRCLSThreadContextGetStackPointer(&registers) ==
+                  (uintptr_t)frame + 2 * sizeof(uintptr_t));
+
+  FIRCLSSyntheticSectionFree(&unwindInfo);
+}
+
+int main(void) {
+  FIRCLSHostTestDwarfShortFDE();
+  FIRCLSHostTestDwarfLongCFIProgram();
+  FIRCLSHostTestDwarfCFAExpression();
+  FIRCLSHostTestCompactUnwindLookup();
+  FIRCLSHostTestCompactUnwindLookupAndCompute();
+
+  if (FIRCLSHostTestFailures > 0) {
+    fprintf(stderr, "%d checks failed\n", FIRCLSHostTestFailures);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Crashlytics/UnitTests/HostUnwind/FIRCLSUnwindSyntheticSections.h"
+
+#include <mach-o/compact_unwind_encoding.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Crashlytics/Crashlytics/Unwind/Dwarf/FIRCLSDwarfUnwindRegisters.h"
+#include "Crashlytics/third_party/libunwind/dwarf.h"
+
+void FIRCLSSyntheticSectionAppend(FIRCLSSyntheticSection* section,
+                                  const void* bytes,
+                                  size_t length) {
+  if (section->length + length > section->capacity) {
+    size_t capacity = section->capacity ? section->capacity : 256;
+    while (capacity < section->length + length) {
+      capacity *= 2;
+    }
+
+    section->bytes = realloc(section->bytes, capacity);
+    if (!section->bytes) {
+      abort();
+    }
+    section->capacity = capacity;
+  }
+
+  memcpy(section->bytes + section->length, bytes, length);
+  section->length += length;
+}
+
+void FIRCLSSyntheticSectionFree(FIRCLSSyntheticSection* section) {
+  free(section->bytes);
+  memset(section, 0, sizeof(FIRCLSSyntheticSection));
+}
+
+static void FIRCLSSyntheticSectionAppendUInt32(FIRCLSSyntheticSection* section, uint32_t value) {
+  FIRCLSSyntheticSectionAppend(section, &value, sizeof(value));
+}
+
+static void FIRCLSSyntheticSectionAppendPointer(FIRCLSSyntheticSection* section, uintptr_t value) {
+  FIRCLSSyntheticSectionAppend(section, &value, sizeof(value));
+}
+
+// Records are padded with DW_CFA_nop, so their lengths stay pointer-aligned like a real __eh_frame.
+static void FIRCLSSyntheticSectionPadRecord(FIRCLSSyntheticSection* section, size_t start) {
+  const uint8_t nop = DW_CFA_nop;
+  while ((section->length - start) % sizeof(uintptr_t) != 0) {
+    FIRCLSSyntheticSectionAppend(section, &nop, 1);
+  }
+
+  uint32_t length = (uint32_t)(section->length - start - sizeof(uint32_t));
+  memcpy(section->bytes + start, &length, sizeof(length));
+}
+
+size_t FIRCLSSyntheticSectionAppendEHFrame(FIRCLSSyntheticSection* section,
+                                           const uint8_t* fdeInstructions,
+                                           size_t fdeInstructionsLength,
+                                           uintptr_t startAddress,
+                                           uintptr_t rangeSize) {
+  const size_t cieStart = section->length;
+  const uint8_t cie[] = {
+      1,                         // version
+      'z', 'R', 0,               // augmentation
+      1,                         // code alignment factor
+      0x80 - sizeof(uintptr_t),  // data alignment factor, as a SLEB128
+      CLS_DWARF_REG_RETURN,      // return address register
+      1,                         // augmentation data length
+      DW_EH_PE_absptr,           // FDE pointer encoding
+      DW_CFA_def_cfa, CLS_DWARF_REG_SP, 2 * sizeof(uintptr_t),
+      DW_CFA_offset | CLS_DWARF_REG_RETURN, 1,
+  };
+
+  FIRCLSSyntheticSectionAppendUInt32(section, 0);
+  FIRCLSSyntheticSectionAppendUInt32(section, DWARF_CIE_ID_CIE_FLAG);
+  FIRCLSSyntheticSectionAppend(section, cie, sizeof(cie));
+  FIRCLSSyntheticSectionPadRecord(section, cieStart);
+
+  const size_t fdeStart = section->length;
+  const uint8_t noAugmentationData = 0;
+
+  FIRCLSSyntheticSectionAppendUInt32(section, 0);
+  FIRCLSSyntheticSectionAppendUInt32(section, (uint32_t)(fdeStart + sizeof(uint32_t) - cieStart));
+  FIRCLSSyntheticSectionAppendPointer(section, startAddress);
+  FIRCLSSyntheticSectionAppendPointer(section, rangeSize);
+  FIRCLSSyntheticSectionAppend(section, &noAugmentationData, 1);
+  FIRCLSSyntheticSectionAppend(section, fdeInstructions, fdeInstructionsLength);
+  FIRCLSSyntheticSectionPadRecord(section, fdeStart);
+
+  return fdeStart;
+}
+
+void FIRCLSSyntheticSectionAppendUnwindInfo(FIRCLSSyntheticSection* section,
+                                            uint32_t pageCount,
+                                            uint32_t functionsPerPage,
+                                            uint32_t functionSize) {
+  // Any non-zero encoding will do, since only the lookup is exercised.
+  const compact_unwind_encoding_t commonEncoding = 0x01000000;
+  const uint32_t pageSize = functionSize * functionsPerPage;
+
+  struct unwind_info_section_header header;
+  memset(&header, 0, sizeof(header));
+  header.version = UNWIND_SECTION_VERSION;
+  header.commonEncodingsArraySectionOffset = sizeof(header);
+  header.commonEncodingsArrayCount = 1;
+  header.indexSectionOffset = sizeof(header) + sizeof(commonEncoding);
+  header.indexCount = pageCount + 1;
+
+  const uint32_t pagesOffset =
+      header.indexSectionOffset +
+      header.indexCount * sizeof(struct unwind_info_section_header_index_entry);
+  const uint32_t pageLength = sizeof(struct unwind_info_compressed_second_level_page_header) +
+                              functionsPerPage * sizeof(uint32_t);
+
+  FIRCLSSyntheticSectionAppend(section, &header, sizeof(header));
+  FIRCLSSyntheticSectionAppend(section, &commonEncoding, sizeof(commonEncoding));
+
+  for (uint32_t i = 0; i <= pageCount; ++i) {
+    struct unwind_info_section_header_index_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.functionOffset = FIRCLSSyntheticUnwindInfoTextStart + i * pageSize;
+    entry.secondLevelPagesSectionOffset = i < pageCount ? pagesOffset + i * pageLength : 0;
+    FIRCLSSyntheticSectionAppend(section, &entry, sizeof(entry));
+  }
+
+  for (uint32_t i = 0; i < pageCount; ++i) {
+    struct unwind_info_compressed_second_level_page_header page;
+    memset(&page, 0, sizeof(page));
+    page.kind = UNWIND_SECOND_LEVEL_COMPRESSED;
+    page.entryPageOffset = sizeof(page);
+    page.entryCount = functionsPerPage;
+    page.encodingsPageOffset = pageLength;
+    FIRCLSSyntheticSectionAppend(section, &page, sizeof(page));
+
+    // Every entry uses common encoding 0, so its upper byte is zero.
+    for (uint32_t j = 0; j < functionsPerPage; ++j) {
+      FIRCLSSyntheticSectionAppendUInt32(section, j * functionSize);
+    }
+  }
+}
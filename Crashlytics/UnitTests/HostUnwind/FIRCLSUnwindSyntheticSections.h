@@ -0,0 +1,50 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Builders for the synthetic __eh_frame and __unwind_info sections that the host tests and
+// benchmarks run the unwinders against. They mirror the ones in FIRCLSUnwindBenchmarkTests.m.
+
+typedef struct {
+  uint8_t* bytes;
+  size_t length;
+  size_t capacity;
+} FIRCLSSyntheticSection;
+
+// The start of the text of the image described by FIRCLSSyntheticSectionAppendUnwindInfo.
+#define FIRCLSSyntheticUnwindInfoTextStart (0x1000)
+
+void FIRCLSSyntheticSectionAppend(FIRCLSSyntheticSection* section,
+                                  const void* bytes,
+                                  size_t length);
+void FIRCLSSyntheticSectionFree(FIRCLSSyntheticSection* section);
+
+// Appends an __eh_frame with one CIE and one FDE, and returns the FDE's offset. The CIE's initial
+// instructions describe a frame with CFA = SP + 2 words and the return address just below the CFA.
+size_t FIRCLSSyntheticSectionAppendEHFrame(FIRCLSSyntheticSection* section,
+                                           const uint8_t* fdeInstructions,
+                                           size_t fdeInstructionsLength,
+                                           uintptr_t startAddress,
+                                           uintptr_t rangeSize);
+
+// Appends an __unwind_info with pageCount compressed second-level pages, each describing
+// functionsPerPage functions of functionSize bytes, all sharing one common encoding.
+void FIRCLSSyntheticSectionAppendUnwindInfo(FIRCLSSyntheticSection* section,
+                                            uint32_t pageCount,
+                                            uint32_t functionsPerPage,
+                                            uint32_t functionSize);
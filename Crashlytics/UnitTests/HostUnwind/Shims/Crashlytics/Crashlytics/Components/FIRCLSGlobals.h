@@ -0,0 +1,22 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host stand-in for the SDK's FIRCLSGlobals.h, which this directory shadows. The unwinders only
+// reach it through FIRCLSUtility.h, for the internal logging macros. The real header declares the
+// crash reporter's global context, which pulls in mach exception ports, libdispatch and the Mach-O
+// image list, none of which the unwinders use.
+
+#pragma once
+
+#include "Crashlytics/Crashlytics/Helpers/FIRCLSInternalLogging.h"
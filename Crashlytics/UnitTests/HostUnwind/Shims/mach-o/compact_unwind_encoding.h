@@ -0,0 +1,105 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host stand-in for the Apple SDK header, declaring the parts of the __unwind_info format that the
+// compact unwinder reads. The layouts and values are those of the format, as documented in
+// <mach-o/compact_unwind_encoding.h>.
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t compact_unwind_encoding_t;
+
+// Architecture independent bits.
+enum {
+  UNWIND_IS_NOT_FUNCTION_START = 0x80000000,
+  UNWIND_HAS_LSDA = 0x40000000,
+  UNWIND_PERSONALITY_MASK = 0x30000000,
+};
+
+// x86_64
+enum {
+  UNWIND_X86_64_MODE_MASK = 0x0F000000,
+  UNWIND_X86_64_MODE_RBP_FRAME = 0x01000000,
+  UNWIND_X86_64_MODE_STACK_IMMD = 0x02000000,
+  UNWIND_X86_64_MODE_STACK_IND = 0x03000000,
+  UNWIND_X86_64_MODE_DWARF = 0x04000000,
+
+  UNWIND_X86_64_RBP_FRAME_REGISTERS = 0x00007FFF,
+  UNWIND_X86_64_RBP_FRAME_OFFSET = 0x00FF0000,
+
+  UNWIND_X86_64_FRAMELESS_STACK_SIZE = 0x00FF0000,
+  UNWIND_X86_64_FRAMELESS_STACK_ADJUST = 0x0000E000,
+  UNWIND_X86_64_FRAMELESS_STACK_REG_COUNT = 0x00001C00,
+  UNWIND_X86_64_FRAMELESS_STACK_REG_PERMUTATION = 0x000003FF,
+
+  UNWIND_X86_64_DWARF_SECTION_OFFSET = 0x00FFFFFF,
+};
+
+enum {
+  UNWIND_X86_64_REG_NONE = 0,
+  UNWIND_X86_64_REG_RBX = 1,
+  UNWIND_X86_64_REG_R12 = 2,
+  UNWIND_X86_64_REG_R13 = 3,
+  UNWIND_X86_64_REG_R14 = 4,
+  UNWIND_X86_64_REG_R15 = 5,
+  UNWIND_X86_64_REG_RBP = 6,
+};
+
+#define UNWIND_SECTION_VERSION 1
+struct unwind_info_section_header {
+  uint32_t version;
+  uint32_t commonEncodingsArraySectionOffset;
+  uint32_t commonEncodingsArrayCount;
+  uint32_t personalityArraySectionOffset;
+  uint32_t personalityArrayCount;
+  uint32_t indexSectionOffset;
+  uint32_t indexCount;
+};
+
+struct unwind_info_section_header_index_entry {
+  uint32_t functionOffset;
+  uint32_t secondLevelPagesSectionOffset;
+  uint32_t lsdaIndexArraySectionOffset;
+};
+
+struct unwind_info_section_header_lsda_index_entry {
+  uint32_t functionOffset;
+  uint32_t lsdaOffset;
+};
+
+struct unwind_info_regular_second_level_entry {
+  uint32_t functionOffset;
+  compact_unwind_encoding_t encoding;
+};
+
+#define UNWIND_SECOND_LEVEL_REGULAR 2
+struct unwind_info_regular_second_level_page_header {
+  uint32_t kind;
+  uint16_t entryPageOffset;
+  uint16_t entryCount;
+};
+
+#define UNWIND_SECOND_LEVEL_COMPRESSED 3
+struct unwind_info_compressed_second_level_page_header {
+  uint32_t kind;
+  uint16_t entryPageOffset;
+  uint16_t entryCount;
+  uint16_t encodingsPageOffset;
+  uint16_t encodingsCount;
+};
+
+#define UNWIND_INFO_COMPRESSED_ENTRY_FUNC_OFFSET(entry) ((entry)&0x00FFFFFF)
+#define UNWIND_INFO_COMPRESSED_ENTRY_ENCODING_INDEX(entry) (((entry) >> 24) & 0xFF)
@@ -0,0 +1,25 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Adds the BSD __printflike annotation, which glibc's sys/cdefs.h doesn't define, to the host's
+// own header.
+
+#pragma once
+
+#include_next <sys/cdefs.h>
+
+#ifndef __printflike
+#define __printflike(fmtarg, firstvararg) \
+  __attribute__((__format__(__printf__, fmtarg, firstvararg)))
+#endif
@@ -0,0 +1,62 @@
+// Copyright 2020 Google
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Adds Darwin's x86_64 thread state, which FIRCLSThreadContext is defined as, to the host's own
+// header. Only the general purpose registers are declared, with Darwin's field names, because
+// those are all the unwinders read and write.
+
+#pragma once
+
+#include_next <sys/ucontext.h>
+
+#include <stdint.h>
+
+#if !defined(__x86_64__)
+#error "The host unwinder harness only supports x86_64."
+#endif
+
+struct __darwin_x86_thread_state64 {
+  uint64_t __rax;
+  uint64_t __rbx;
+  uint64_t __rcx;
+  uint64_t __rdx;
+  uint64_t __rdi;
+  uint64_t __rsi;
+  uint64_t __rbp;
+  uint64_t __rsp;
+  uint64_t __r8;
+  uint64_t __r9;
+  uint64_t __r10;
+  uint64_t __r11;
+  uint64_t __r12;
+  uint64_t __r13;
+  uint64_t __r14;
+  uint64_t __r15;
+  uint64_t __rip;
+  uint64_t __rflags;
+  uint64_t __cs;
+  uint64_t __fs;
+  uint64_t __gs;
+};
+
+struct __darwin_mcontext64 {
+  struct __darwin_x86_thread_state64 __ss;
+};
+
+struct __darwin_ucontext {
+  struct __darwin_mcontext64 uc_mcontext;
+};
+
+#define _STRUCT_MCONTEXT struct __darwin_mcontext64
+#define _STRUCT_UCONTEXT struct __darwin_ucontext
@@ -194,8 +194,10 @@ class RemoteStoreEventCapture : public RemoteStoreCallback {
     [underlying_capture_ rejectListenWithTargetID:target_id error:error.ToNSError()];
   }
 
-  void HandleSuccessfulWrite(const MutationBatchResult &batch_result) override {
-    [underlying_capture_ applySuccessfulWriteWithResult:batch_result];
+  void HandleSuccessfulWrites(const std::vector<MutationBatchResult> &batch_results) override {
+    for (const MutationBatchResult &batch_result : batch_results) {
+      [underlying_capture_ applySuccessfulWriteWithResult:batch_result];
+    }
   }
 
   void HandleRejectedWrite(BatchId batch_id, Status error) override {
@@ -411,6 +411,11 @@ NS_ASSUME_NONNULL_BEGIN
   _workerQueue->EnqueueBlocking(
       [&] { _datastore->AckWrite(commitVersion, std::move(mutationResults)); });
 
+  // The remote store applies acknowledgements as a group, shortly after receiving them.
+  if (_workerQueue->IsScheduled(TimerId::ApplyWriteResults)) {
+    _workerQueue->RunScheduledOperationsUntil(TimerId::ApplyWriteResults);
+  }
+
   return write;
 }
 
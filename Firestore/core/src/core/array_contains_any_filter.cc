@@ -17,10 +17,10 @@
 #include "Firestore/core/src/core/array_contains_any_filter.h"
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
 
 #include "Firestore/core/src/model/document.h"
-#include "absl/algorithm/container.h"
 
 namespace firebase {
 namespace firestore {
@@ -29,6 +29,7 @@ namespace core {
 using model::Document;
 using model::FieldPath;
 using model::FieldValue;
+using model::FieldValueHash;
 
 using Operator = Filter::Operator;
 
@@ -36,7 +37,9 @@ class ArrayContainsAnyFilter::Rep : public FieldFilter::Rep {
  public:
   Rep(FieldPath field, FieldValue value)
       : FieldFilter::Rep(
-            std::move(field), Operator::ArrayContainsAny, std::move(value)) {
+            std::move(field), Operator::ArrayContainsAny, std::move(value)),
+        values_(this->value().array_value().begin(),
+                this->value().array_value().end()) {
   }
 
   Type type() const override {
@@ -44,6 +47,10 @@ class ArrayContainsAnyFilter::Rep : public FieldFilter::Rep {
   }
 
   bool Matches(const model::Document& doc) const override;
+
+ private:
+  /** The elements of the filter's array value, hashed for quick lookup. */
+  std::unordered_set<FieldValue, FieldValueHash> values_;
 };
 
 ArrayContainsAnyFilter::ArrayContainsAnyFilter(FieldPath field,
@@ -52,15 +59,14 @@ ArrayContainsAnyFilter::ArrayContainsAnyFilter(FieldPath field,
 }
 
 bool ArrayContainsAnyFilter::Rep::Matches(const Document& doc) const {
-  const FieldValue::Array& array_value = value().array_value();
-  absl::optional<FieldValue> maybe_lhs = doc.field(field());
+  const FieldValue* maybe_lhs = doc.FindField(field());
   if (!maybe_lhs) return false;
 
   const FieldValue& lhs = *maybe_lhs;
   if (lhs.type() != FieldValue::Type::Array) return false;
 
   for (const auto& val : lhs.array_value()) {
-    if (absl::c_linear_search(array_value, val)) {
+    if (values_.find(val) != values_.end()) {
       return true;
     }
   }
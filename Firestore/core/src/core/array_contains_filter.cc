@@ -52,7 +52,7 @@ ArrayContainsFilter::ArrayContainsFilter(FieldPath field, FieldValue value)
 }
 
 bool ArrayContainsFilter::Rep::Matches(const Document& doc) const {
-  absl::optional<FieldValue> maybe_lhs = doc.field(field());
+  const FieldValue* maybe_lhs = doc.FindField(field());
   if (!maybe_lhs) return false;
 
   const FieldValue& lhs = *maybe_lhs;
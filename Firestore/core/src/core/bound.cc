@@ -52,10 +52,10 @@ bool Bound::SortsBeforeDocument(const OrderByList& order_by,
       comparison = ref.key().CompareTo(document.key());
 
     } else {
-      absl::optional<FieldValue> doc_value =
-          document.field(ordering_component.field());
+      const FieldValue* doc_value =
+          document.FindField(ordering_component.field());
       HARD_ASSERT(
-          doc_value.has_value(),
+          doc_value != nullptr,
           "Field should exist since document matched the orderBy already.");
       comparison = field_value.CompareTo(*doc_value);
     }
@@ -135,7 +135,7 @@ bool FieldFilter::Rep::IsInequality() const {
 }
 
 bool FieldFilter::Rep::Matches(const model::Document& doc) const {
-  absl::optional<FieldValue> maybe_lhs = doc.field(field_);
+  const FieldValue* maybe_lhs = doc.FindField(field_);
   if (!maybe_lhs) return false;
 
   const FieldValue& lhs = *maybe_lhs;
@@ -17,10 +17,10 @@
 #include "Firestore/core/src/core/not_in_filter.h"
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
 
 #include "Firestore/core/src/model/document.h"
-#include "absl/algorithm/container.h"
 
 namespace firebase {
 namespace firestore {
@@ -29,13 +29,16 @@ namespace core {
 using model::Document;
 using model::FieldPath;
 using model::FieldValue;
+using model::FieldValueHash;
 
 using Operator = Filter::Operator;
 
 class NotInFilter::Rep : public FieldFilter::Rep {
  public:
   Rep(FieldPath field, FieldValue value)
-      : FieldFilter::Rep(std::move(field), Operator::NotIn, std::move(value)) {
+      : FieldFilter::Rep(std::move(field), Operator::NotIn, std::move(value)),
+        values_(this->value().array_value().begin(),
+                this->value().array_value().end()) {
   }
 
   Type type() const override {
@@ -43,6 +46,10 @@ class NotInFilter::Rep : public FieldFilter::Rep {
   }
 
   bool Matches(const model::Document& doc) const override;
+
+ private:
+  /** The elements of the filter's array value, hashed for quick lookup. */
+  std::unordered_set<FieldValue, FieldValueHash> values_;
 };
 
 NotInFilter::NotInFilter(FieldPath field, FieldValue value)
@@ -51,12 +58,11 @@ NotInFilter::NotInFilter(FieldPath field, FieldValue value)
 }
 
 bool NotInFilter::Rep::Matches(const Document& doc) const {
-  const FieldValue::Array& array_value = value().array_value();
-  if (absl::c_linear_search(array_value, FieldValue::Null())) {
+  if (values_.find(FieldValue::Null()) != values_.end()) {
     return false;
   }
-  absl::optional<FieldValue> maybe_lhs = doc.field(field());
-  return maybe_lhs && !absl::c_linear_search(array_value, *maybe_lhs);
+  const FieldValue* maybe_lhs = doc.FindField(field());
+  return maybe_lhs && values_.find(*maybe_lhs) == values_.end();
 }
 
 }  // namespace core
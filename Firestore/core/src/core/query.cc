@@ -25,6 +25,7 @@
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_mask.h"
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/util/equality.h"
@@ -43,6 +44,7 @@ using Type = Filter::Type;
 using model::Document;
 using model::DocumentComparator;
 using model::DocumentKey;
+using model::FieldMask;
 using model::FieldPath;
 using model::ResourcePath;
 using util::ComparisonResult;
@@ -253,7 +255,7 @@ bool Query::MatchesOrderBy(const Document& doc) const {
     const FieldPath& field_path = order_by.field();
     // order by key always matches
     if (field_path != FieldPath::KeyFieldPath() &&
-        doc.field(field_path) == absl::nullopt) {
+        doc.FindField(field_path) == nullptr) {
       return false;
     }
   }
@@ -271,6 +273,27 @@ bool Query::MatchesBounds(const Document& doc) const {
   return true;
 }
 
+bool Query::MayBeAffectedBy(const FieldMask& fields) const {
+  auto overlaps = [&](const FieldPath& query_field) {
+    for (const FieldPath& field : fields) {
+      if (field.IsPrefixOf(query_field) || query_field.IsPrefixOf(field)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (const Filter& filter : filters_) {
+    if (overlaps(filter.field())) return true;
+  }
+  // Bounds are expressed in terms of the (implicit and explicit) order by
+  // fields, so this covers them too.
+  for (const OrderBy& order_by : order_bys()) {
+    if (overlaps(order_by.field())) return true;
+  }
+  return false;
+}
+
 model::DocumentComparator Query::Comparator() const {
   OrderByList ordering = order_bys();
 
@@ -224,6 +224,13 @@ class Query {
   /** Returns true if the document matches the constraints of this query. */
   bool Matches(const model::Document& doc) const;
 
+  /**
+   * Returns true if changing the given fields of a document may change whether
+   * the document matches this query or where it sorts in the results, i.e. if
+   * any of the fields overlaps a field this query filters or orders by.
+   */
+  bool MayBeAffectedBy(const model::FieldMask& fields) const;
+
   /**
    * Returns a comparator that will sort documents according to the order by
    * clauses in this query.
@@ -61,6 +61,7 @@ using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentUpdateMap;
+using model::FieldMaskMap;
 using model::kBatchIdUnknown;
 using model::ListenSequenceNumber;
 using model::MaybeDocumentMap;
@@ -208,7 +209,8 @@ void SyncEngine::WriteMutations(std::vector<model::Mutation>&& mutations,
   mutation_callbacks_[current_user_].insert(
       std::make_pair(result.batch_id(), std::move(callback)));
 
-  EmitNewSnapshotsAndNotifyLocalStore(result.changes(), absl::nullopt);
+  EmitNewSnapshotsAndNotifyLocalStore(result.changes(), absl::nullopt,
+                                      result.changed_fields());
   remote_store_->FillWritePipeline();
 }
 
@@ -250,6 +252,11 @@ void SyncEngine::Transaction(int retries,
 
 void SyncEngine::HandleCredentialChange(const auth::User& user) {
   bool user_changed = (current_user_ != user);
+  if (user_changed) {
+    // Writes acknowledged for the previous user belong to their mutation
+    // queue, and their callbacks are registered under that user.
+    remote_store_->ApplyPendingWriteResults();
+  }
   current_user_ = user;
 
   if (user_changed) {
@@ -346,19 +353,21 @@ void SyncEngine::HandleRejectedListen(TargetId target_id, Status error) {
   }
 }
 
-void SyncEngine::HandleSuccessfulWrite(
-    const model::MutationBatchResult& batch_result) {
-  AssertCallbackExists("HandleSuccessfulWrite");
+void SyncEngine::HandleSuccessfulWrites(
+    const std::vector<model::MutationBatchResult>& batch_results) {
+  AssertCallbackExists("HandleSuccessfulWrites");
 
-  // The local store may or may not be able to apply the write result and
+  // The local store may or may not be able to apply the write results and
   // raise events immediately (depending on whether the watcher is caught up),
   // so we raise user callbacks first so that they consistently happen before
   // listen events.
-  NotifyUser(batch_result.batch().batch_id(), Status::OK());
+  for (const model::MutationBatchResult& batch_result : batch_results) {
+    NotifyUser(batch_result.batch().batch_id(), Status::OK());
 
-  TriggerPendingWriteCallbacks(batch_result.batch().batch_id());
+    TriggerPendingWriteCallbacks(batch_result.batch().batch_id());
+  }
 
-  MaybeDocumentMap changes = local_store_->AcknowledgeBatch(batch_result);
+  MaybeDocumentMap changes = local_store_->AcknowledgeBatches(batch_results);
   EmitNewSnapshotsAndNotifyLocalStore(changes, absl::nullopt);
 }
 
@@ -464,14 +473,16 @@ void SyncEngine::FailOutstandingPendingWriteCallbacks(
 
 void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
     const MaybeDocumentMap& changes,
-    const absl::optional<RemoteEvent>& maybe_remote_event) {
+    const absl::optional<RemoteEvent>& maybe_remote_event,
+    const FieldMaskMap& changed_fields) {
   std::vector<ViewSnapshot> new_snapshots;
   std::vector<LocalViewChanges> document_changes_in_all_views;
 
   for (const auto& entry : query_views_by_query_) {
     const auto& query_view = entry.second;
     View& view = query_view->view();
-    ViewDocumentChanges view_doc_changes = view.ComputeDocumentChanges(changes);
+    ViewDocumentChanges view_doc_changes =
+        view.ComputeDocumentChanges(changes, absl::nullopt, changed_fields);
     if (view_doc_changes.needs_refill()) {
       // The query has a limit and some docs were removed/updated, so we need to
       // re-run the query against the local store to make sure we didn't lose
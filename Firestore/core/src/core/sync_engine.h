@@ -144,8 +144,8 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
   void ApplyRemoteEvent(const remote::RemoteEvent& remote_event) override;
   void HandleRejectedListen(model::TargetId target_id,
                             util::Status error) override;
-  void HandleSuccessfulWrite(
-      const model::MutationBatchResult& batch_result) override;
+  void HandleSuccessfulWrites(
+      const std::vector<model::MutationBatchResult>& batch_results) override;
   void HandleRejectedWrite(model::BatchId batch_id,
                            util::Status error) override;
   void HandleOnlineStateChange(model::OnlineState online_state) override;
@@ -235,9 +235,16 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
 
   void RemoveLimboTarget(const model::DocumentKey& key);
 
+  /**
+   * Computes new snapshots for all views from the given document changes.
+   *
+   * `changed_fields` tells, for the documents that a local write only patched,
+   * which fields may have changed; see `View::ComputeDocumentChanges`.
+   */
   void EmitNewSnapshotsAndNotifyLocalStore(
       const model::MaybeDocumentMap& changes,
-      const absl::optional<remote::RemoteEvent>& maybe_remote_event);
+      const absl::optional<remote::RemoteEvent>& maybe_remote_event,
+      const model::FieldMaskMap& changed_fields = {});
 
   /** Updates the limbo document state for the given target_id. */
   void UpdateTrackedLimboDocuments(
@@ -30,6 +30,7 @@ using model::Document;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentSet;
+using model::FieldMaskMap;
 using model::MaybeDocument;
 using model::MaybeDocumentMap;
 using model::OnlineState;
@@ -96,7 +97,8 @@ ComparisonResult View::Compare(const Document& lhs, const Document& rhs) const {
 
 ViewDocumentChanges View::ComputeDocumentChanges(
     const MaybeDocumentMap& doc_changes,
-    const absl::optional<ViewDocumentChanges>& previous_changes) const {
+    const absl::optional<ViewDocumentChanges>& previous_changes,
+    const FieldMaskMap& changed_fields) const {
   DocumentViewChangeSet change_set;
   if (previous_changes) {
     change_set = previous_changes->change_set();
@@ -139,11 +141,15 @@ ViewDocumentChanges View::ComputeDocumentChanges(
     if (maybe_new_doc.is_document()) {
       new_doc = Document(maybe_new_doc);
     }
+    // A document in the view that was only patched in fields the query
+    // doesn't filter or order by still matches, and sorts in the same place.
+    bool same_match_and_order =
+        old_doc && new_doc && OnlyIrrelevantFieldsChanged(key, changed_fields);
     if (new_doc) {
       HARD_ASSERT(key == new_doc->key(),
                   "Mismatching key in document changes: %s != %s",
                   key.ToString(), new_doc->key().ToString());
-      if (!query_.Matches(*new_doc)) {
+      if (!same_match_and_order && !query_.Matches(*new_doc)) {
         new_doc = absl::nullopt;
       }
     }
@@ -169,10 +175,10 @@ ViewDocumentChanges View::ComputeDocumentChanges(
           change_applied = true;
 
           bool outside_limit =
-              last_doc_in_limit &&
+              !same_match_and_order && last_doc_in_limit &&
               util::Descending(Compare(*new_doc, *last_doc_in_limit));
           bool outside_limit_to_last =
-              first_doc_in_limit &&
+              !same_match_and_order && first_doc_in_limit &&
               util::Ascending(Compare(*new_doc, *first_doc_in_limit));
           if (outside_limit || outside_limit_to_last) {
             // This doc moved from inside the limit to after the limit. That
@@ -244,6 +250,13 @@ ViewDocumentChanges View::ComputeDocumentChanges(
                              new_mutated_keys, needs_refill);
 }
 
+bool View::OnlyIrrelevantFieldsChanged(
+    const DocumentKey& key, const FieldMaskMap& changed_fields) const {
+  auto found = changed_fields.find(key);
+  return found != changed_fields.end() &&
+         !query_.MayBeAffectedBy(found->second);
+}
+
 bool View::ShouldWaitForSyncedDocument(const Document& new_doc,
                                        const Document& old_doc) const {
   // We suppress the initial change event for documents that were modified as
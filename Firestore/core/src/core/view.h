@@ -21,8 +21,11 @@
 #include <vector>
 
 #include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_mask.h"
+#include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/remote/remote_event.h"
 
@@ -154,12 +157,18 @@ class View {
    * @param doc_changes The doc changes to apply to this view.
    * @param previous_changes If this is being called with a refill, then start
    *     with this set of docs and changes instead of the current view.
+   * @param changed_fields For the changes that come from a local write, the
+   *     fields that may have changed in the documents the write only patched.
+   *     If a document already in the view was only patched in fields this
+   *     query doesn't filter or order by, it still matches the query and keeps
+   *     its position, so the query isn't re-evaluated against it.
    * @return a new set of docs, changes, and refill flag.
    */
   core::ViewDocumentChanges ComputeDocumentChanges(
       const model::MaybeDocumentMap& doc_changes,
       const absl::optional<core::ViewDocumentChanges>& previous_changes =
-          absl::nullopt) const;
+          absl::nullopt,
+      const model::FieldMaskMap& changed_fields = {}) const;
 
   /**
    * Updates the view with the given ViewDocumentChanges.
@@ -193,6 +202,14 @@ class View {
   }
 
  private:
+  /**
+   * Returns true if the fields that may have changed in the document with the
+   * given key can't affect whether it matches the query or where it sorts.
+   */
+  bool OnlyIrrelevantFieldsChanged(
+      const model::DocumentKey& key,
+      const model::FieldMaskMap& changed_fields) const;
+
   util::ComparisonResult Compare(const model::Document& lhs,
                                  const model::Document& rhs) const;
 
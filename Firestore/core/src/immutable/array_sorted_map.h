@@ -152,6 +152,18 @@ class ArraySortedMap : public SortedMapBase {
       : array_{SortedArray(entries, comparator)}, comparator_{comparator} {
   }
 
+  /**
+   * Creates an ArraySortedMap from a range of pairs that is already sorted by
+   * key and contains no duplicate keys.
+   */
+  template <typename Range>
+  static ArraySortedMap CreateFromSorted(const Range& range,
+                                         const C& comparator) {
+    return ArraySortedMap{
+        std::make_shared<const array_type>(range.begin(), range.end()),
+        comparator};
+  }
+
   /** Returns true if the map contains no elements. */
   bool empty() const {
     return size() == 0;
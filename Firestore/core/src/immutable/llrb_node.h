@@ -101,6 +101,14 @@ class LlrbNode : public SortedMapBase {
   template <typename Comparator>
   LlrbNode erase(const K& key, const Comparator& comparator) const;
 
+  /**
+   * Builds a tree from `size` entries starting at `begin`, which must already
+   * be sorted by key and free of duplicates. Runs in linear time rather than
+   * the O(n log n) of repeated insertion.
+   */
+  template <typename Iterator>
+  static LlrbNode FromSorted(Iterator begin, size_type size);
+
   const LlrbNode& min() const {
     const LlrbNode* node = this;
     while (!node->left().empty()) {
@@ -221,6 +229,15 @@ class LlrbNode : public SortedMapBase {
   template <typename Comparator>
   LlrbNode InnerErase(const K& key, const Comparator& comparator) const;
 
+  template <typename Iterator>
+  static LlrbNode BuildPennant(Iterator& it,
+                               size_type size,
+                               Color color,
+                               LlrbNode left);
+
+  template <typename Iterator>
+  static LlrbNode BuildPerfect(Iterator& it, size_type size);
+
   void FixUp();
   void FixRootColor();
 
@@ -280,6 +297,61 @@ LlrbNode<K, V> LlrbNode<K, V>::InnerInsert(const K& key,
   return result;
 }
 
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::FromSorted(Iterator begin, size_type size) {
+  // Lay the entries out along a left spine of "pennants": nodes whose right
+  // child is a perfect, all-black tree of 2^i - 1 entries. Each bit of
+  // size + 1 below its leading one contributes a black pennant of 2^i
+  // entries, with a red pennant of the same size hanging off its left when
+  // the bit is set. Every path then crosses the same number of black nodes
+  // and red nodes only appear as left children, so the result is a valid
+  // left-leaning red-black tree.
+  size_type bits = size + 1;
+  size_type height = 0;
+  while ((bits >> (height + 1)) != 0) {
+    ++height;
+  }
+
+  LlrbNode spine;
+  for (size_type i = 0; i < height; ++i) {
+    size_type pennant_size = size_type{1} << i;
+    if (bits & pennant_size) {
+      spine = BuildPennant(begin, pennant_size, Color::Red, std::move(spine));
+    }
+    spine = BuildPennant(begin, pennant_size, Color::Black, std::move(spine));
+  }
+  return spine;
+}
+
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::BuildPennant(Iterator& it,
+                                            size_type size,
+                                            Color color,
+                                            LlrbNode left) {
+  value_type entry{*it};
+  ++it;
+  LlrbNode right = BuildPerfect(it, size - 1);
+  return LlrbNode{Rep{std::move(entry), color, std::move(left),
+                      std::move(right)}};
+}
+
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::BuildPerfect(Iterator& it, size_type size) {
+  if (size == 0) {
+    return LlrbNode{};
+  }
+
+  LlrbNode left = BuildPerfect(it, size / 2);
+  value_type entry{*it};
+  ++it;
+  LlrbNode right = BuildPerfect(it, size / 2);
+  return LlrbNode{Rep{std::move(entry), Color::Black, std::move(left),
+                      std::move(right)}};
+}
+
 template <typename K, typename V>
 template <typename Comparator>
 LlrbNode<K, V> LlrbNode<K, V>::erase(const K& key,
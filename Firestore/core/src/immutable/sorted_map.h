@@ -73,6 +73,21 @@ class SortedMap : public SortedMapBase {
     }
   }
 
+  /**
+   * Creates a SortedMap from a range of entries that is already sorted by key
+   * and contains no duplicate keys. This avoids the per-entry rebalancing of
+   * repeated insertion, so it runs in linear time.
+   */
+  template <typename Range>
+  static SortedMap CreateFromSorted(const Range& entries,
+                                    const C& comparator = {}) {
+    if (entries.size() <= kFixedSize) {
+      return SortedMap{array_type::CreateFromSorted(entries, comparator)};
+    } else {
+      return SortedMap{tree_type::CreateFromSorted(entries, comparator)};
+    }
+  }
+
   SortedMap(const SortedMap& other) : tag_{other.tag_} {
     switch (tag_) {
       case Tag::Array:
@@ -74,6 +74,18 @@ class TreeSortedMap : public SortedMapBase, private util::CompressedMember<C> {
     return TreeSortedMap{std::move(node), comparator};
   }
 
+  /**
+   * Creates a TreeSortedMap from a range of pairs that is already sorted by
+   * key and contains no duplicate keys, in linear time.
+   */
+  template <typename Range>
+  static TreeSortedMap CreateFromSorted(const Range& range,
+                                        const C& comparator) {
+    auto size = static_cast<size_type>(range.size());
+    return TreeSortedMap{node_type::FromSorted(range.begin(), size),
+                         comparator};
+  }
+
   /** Returns true if the map contains no elements. */
   bool empty() const {
     return root_.empty();
@@ -42,12 +42,14 @@ const char* kDocumentMutationsTable = "document_mutation";
 const char* kMutationQueuesTable = "mutation_queue";
 const char* kTargetGlobalTable = "target_global";
 const char* kTargetsTable = "target";
+const char* kTargetStatesTable = "target_state";
 const char* kQueryTargetsTable = "query_target";
 const char* kTargetDocumentsTable = "target_document";
 const char* kDocumentTargetsTable = "document_target";
 const char* kRemoteDocumentsTable = "remote_document";
 const char* kCollectionParentsTable = "collection_parent";
 const char* kRemoteDocumentReadTimeTable = "remote_document_read_time";
+const char* kCollectionGroupDocumentsTable = "collection_group_document";
 const char* kBundlesTable = "bundles";
 const char* kNamedQueriesTable = "named_queries";
 
@@ -836,6 +838,28 @@ bool LevelDbTargetKey::Decode(leveldb::Slice key) {
   return reader.ok();
 }
 
+std::string LevelDbTargetStateKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kTargetStatesTable);
+  return writer.result();
+}
+
+std::string LevelDbTargetStateKey::Key(model::TargetId target_id) {
+  Writer writer;
+  writer.WriteTableName(kTargetStatesTable);
+  writer.WriteTargetId(target_id);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbTargetStateKey::Decode(leveldb::Slice key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kTargetStatesTable);
+  target_id_ = reader.ReadTargetId();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 std::string LevelDbQueryTargetKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kQueryTargetsTable);
@@ -1017,6 +1041,12 @@ bool LevelDbCollectionParentKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kRemoteDocumentReadTimeTable);
+  return writer.result();
+}
+
 std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
     const model::ResourcePath& collection_path,
     model::SnapshotVersion read_time) {
@@ -1050,6 +1080,61 @@ bool LevelDbRemoteDocumentReadTimeKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbCollectionGroupDocumentKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kCollectionGroupDocumentsTable);
+  return writer.result();
+}
+
+std::string LevelDbCollectionGroupDocumentKey::KeyPrefix(
+    absl::string_view collection_id) {
+  Writer writer;
+  writer.WriteTableName(kCollectionGroupDocumentsTable);
+  writer.WriteCollectionId(collection_id);
+  return writer.result();
+}
+
+std::string LevelDbCollectionGroupDocumentKey::Key(
+    const DocumentKey& document_key) {
+  const ResourcePath& path = document_key.path();
+  Writer writer;
+  writer.WriteTableName(kCollectionGroupDocumentsTable);
+  writer.WriteCollectionId(path[path.size() - 2]);
+  writer.WriteResourcePath(path);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+std::string LevelDbCollectionGroupDocumentKey::EncodeReadTimeValue(
+    model::SnapshotVersion read_time) {
+  std::string encoded;
+  OrderedCode::WriteSignedNumIncreasing(&encoded,
+                                        read_time.timestamp().seconds());
+  OrderedCode::WriteSignedNumIncreasing(&encoded,
+                                        read_time.timestamp().nanoseconds());
+  return encoded;
+}
+
+model::SnapshotVersion LevelDbCollectionGroupDocumentKey::DecodeReadTimeValue(
+    absl::string_view slice) {
+  int64_t seconds;
+  int64_t nanos;
+  if (!OrderedCode::ReadSignedNumIncreasing(&slice, &seconds) ||
+      !OrderedCode::ReadSignedNumIncreasing(&slice, &nanos)) {
+    HARD_FAIL("Failed to read read time from a collection group document row");
+  }
+  return model::SnapshotVersion({seconds, static_cast<int32_t>(nanos)});
+}
+
+bool LevelDbCollectionGroupDocumentKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kCollectionGroupDocumentsTable);
+  collection_id_ = reader.ReadCollectionId();
+  document_key_ = reader.ReadDocumentKey();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 std::string LevelDbBundleKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kBundlesTable);
@@ -57,6 +57,10 @@ namespace local {
 //   - table_name: string = "target"
 //   - target_id: model::TargetId
 //
+// target_states:
+//   - table_name: string = "target_state"
+//   - target_id: model::TargetId
+//
 // target_globals:
 //   - table_name: string = "target_global"
 //
@@ -90,6 +94,11 @@ namespace local {
 //   - read_time: SnapshotVersion
 //   - document_id: string
 //
+// collection_group_documents:
+//   - table_name: string = "collection_group_document"
+//   - collection_id: string
+//   - path: ResourcePath
+//
 // bundles:
 //   - table_name: string = "bundles"
 //   - bundle_id: string
@@ -314,6 +323,47 @@ class LevelDbTargetKey {
   model::TargetId target_id_ = 0;
 };
 
+/**
+ * A key in the target states table, which holds the parts of each target that
+ * change as the target is listened to: its resume token, snapshot versions and
+ * sequence number.
+ *
+ * The row for a target only exists once the target has been updated after
+ * being added. When it exists, it takes precedence over the same fields in the
+ * target's row in the targets table, which are written only once.
+ */
+class LevelDbTargetStateKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key in the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a complete key that points to the state of a specific target, by
+   * target_id.
+   */
+  static std::string Key(model::TargetId target_id);
+
+  /**
+   * Decodes the contents of a target state key, storing the decoded values in
+   * this instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(leveldb::Slice key);
+
+  model::TargetId target_id() {
+    return target_id_;
+  }
+
+ private:
+  model::TargetId target_id_ = 0;
+};
+
 /**
  * A key in the query targets table, an index of canonical_ids to the targets
  * they may match. This is not a unique mapping because canonical_id does not
@@ -597,6 +647,11 @@ class LevelDbCollectionParentKey {
  */
 class LevelDbRemoteDocumentReadTimeKey {
  public:
+  /**
+   * Creates a key prefix that points just before the first key in the table.
+   */
+  static std::string KeyPrefix();
+
   /**
    * Creates a key prefix that points just before the first key for the given
    * collection_path and read_time.
@@ -643,6 +698,70 @@ class LevelDbRemoteDocumentReadTimeKey {
   model::SnapshotVersion read_time_;
 };
 
+/**
+ * A key in the collection group documents index, which associates a
+ * Collection ID (e.g. 'messages') with the path of every remote document that
+ * lives directly in a collection with that ID (e.g. '/chats/123/messages/abc').
+ * This allows a Collection Group query to find all of its candidate documents
+ * with a single range scan. The value of each row is the document's read time,
+ * encoded with `EncodeReadTimeValue`.
+ */
+class LevelDbCollectionGroupDocumentKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key in the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a key prefix that points just before the first key for the given
+   * collection_id.
+   */
+  static std::string KeyPrefix(absl::string_view collection_id);
+
+  /**
+   * Creates a complete key that points to the given document. The collection_id
+   * is taken from the document's parent collection.
+   */
+  static std::string Key(const model::DocumentKey& document_key);
+
+  /**
+   * Given a read time, encodes it for storage as the value of an index row.
+   */
+  static std::string EncodeReadTimeValue(model::SnapshotVersion read_time);
+
+  /**
+   * Given an encoded index row value, returns the read time.
+   */
+  static model::SnapshotVersion DecodeReadTimeValue(absl::string_view slice);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The collection_id, as encoded in the key. */
+  const std::string& collection_id() const {
+    return collection_id_;
+  }
+
+  /** The path to the document, as encoded in the key. */
+  const model::DocumentKey& document_key() const {
+    return document_key_;
+  }
+
+ private:
+  // Deliberately uninitialized: will be assigned in Decode
+  std::string collection_id_;
+  model::DocumentKey document_key_;
+};
+
 /**
  * A key in the bundles table, storing the bundle Id for each entry.
  */
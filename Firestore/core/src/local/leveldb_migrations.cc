@@ -24,6 +24,7 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/memory_index_manager.h"
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
@@ -41,6 +42,7 @@ using leveldb::Status;
 using leveldb::WriteOptions;
 using model::DocumentKey;
 using model::ResourcePath;
+using model::SnapshotVersion;
 using nanopb::Message;
 using nanopb::StringReader;
 using nanopb::Writer;
@@ -65,8 +67,10 @@ using nanopb::Writer;
  *     has a sentinel row with a sequence number.
  *   * Migration 5 drops held write acks.
  *   * Migration 6 populates the collection_parents index.
+ *   * Migration 7 populates the collection_group_documents index.
+ *   * Migration 8 drops target states, which may be older than their targets.
  */
-const LevelDbMigrations::SchemaVersion kSchemaVersion = 6;
+const LevelDbMigrations::SchemaVersion kSchemaVersion = 8;
 
 /**
  * Save the given version number as the current version of the schema of the
@@ -104,6 +108,7 @@ void DeleteEverythingWithPrefix(const std::string& prefix, leveldb::DB* db) {
 /** Migration 3. */
 void ClearQueryCache(leveldb::DB* db) {
   DeleteEverythingWithPrefix(LevelDbTargetKey::KeyPrefix(), db);
+  DeleteEverythingWithPrefix(LevelDbTargetStateKey::KeyPrefix(), db);
   DeleteEverythingWithPrefix(LevelDbDocumentTargetKey::KeyPrefix(), db);
   DeleteEverythingWithPrefix(LevelDbTargetDocumentKey::KeyPrefix(), db);
   DeleteEverythingWithPrefix(LevelDbQueryTargetKey::KeyPrefix(), db);
@@ -303,6 +308,86 @@ void EnsureCollectionParentsIndex(leveldb::DB* db) {
   transaction.Commit();
 }
 
+/**
+ * Migration 7.
+ *
+ * Creates LevelDbCollectionGroupDocumentKey rows for all documents in the
+ * remote document cache, carrying over the latest read time recorded for each
+ * document in the remote_document_read_time table.
+ */
+void EnsureCollectionGroupDocumentsIndex(leveldb::DB* db) {
+  // Any existing rows may be stale if the client was downgraded and upgraded
+  // again, so rebuild the index from scratch.
+  DeleteEverythingWithPrefix(LevelDbCollectionGroupDocumentKey::KeyPrefix(),
+                             db);
+
+  LevelDbTransaction transaction(db, "Ensure Collection Group Documents Index");
+
+  // Index existing remote documents. Documents that were written before read
+  // times were tracked have no read time.
+  std::string none_value =
+      LevelDbCollectionGroupDocumentKey::EncodeReadTimeValue(
+          SnapshotVersion::None());
+  std::string documents_prefix = LevelDbRemoteDocumentKey::KeyPrefix();
+  auto it = transaction.NewIterator();
+  it->Seek(documents_prefix);
+  LevelDbRemoteDocumentKey document_key;
+  for (; it->Valid() && absl::StartsWith(it->key(), documents_prefix);
+       it->Next()) {
+    HARD_ASSERT(document_key.Decode(it->key()),
+                "Failed to decode document key");
+
+    transaction.Put(
+        LevelDbCollectionGroupDocumentKey::Key(document_key.document_key()),
+        none_value);
+  }
+
+  // Copy over read times. Rows are ordered by read time within each
+  // collection, so the last row seen for a document holds its latest read
+  // time. Rows for documents that are no longer cached are skipped.
+  std::string read_time_prefix = LevelDbRemoteDocumentReadTimeKey::KeyPrefix();
+  it = transaction.NewIterator();
+  it->Seek(read_time_prefix);
+  LevelDbRemoteDocumentReadTimeKey read_time_key;
+  std::string existing_value;
+  for (; it->Valid() && absl::StartsWith(it->key(), read_time_prefix);
+       it->Next()) {
+    HARD_ASSERT(read_time_key.Decode(it->key()),
+                "Failed to decode remote document read time key");
+
+    DocumentKey key(
+        read_time_key.collection_path().Append(read_time_key.document_id()));
+    std::string index_key = LevelDbCollectionGroupDocumentKey::Key(key);
+    if (transaction.Get(index_key, &existing_value).ok()) {
+      transaction.Put(index_key,
+                      LevelDbCollectionGroupDocumentKey::EncodeReadTimeValue(
+                          read_time_key.read_time()));
+    }
+  }
+
+  SaveVersion(7, &transaction);
+  transaction.Commit();
+}
+
+/**
+ * Migration 8.
+ *
+ * From this version on, updates to a target only rewrite its row in the
+ * target_state table, which takes precedence over the target's own row. A
+ * client downgraded to an older version updates the targets' own rows
+ * instead, so any target states left over from before the downgrade may be
+ * older than the targets they'd override. Drop them: an older resume token,
+ * snapshot version or sequence number only means that the target resumes from
+ * further back, or becomes eligible for garbage collection sooner.
+ */
+void DropTargetStates(leveldb::DB* db) {
+  DeleteEverythingWithPrefix(LevelDbTargetStateKey::KeyPrefix(), db);
+
+  LevelDbTransaction transaction(db, "Drop Target States");
+  SaveVersion(8, &transaction);
+  transaction.Commit();
+}
+
 }  // namespace
 
 LevelDbMigrations::SchemaVersion LevelDbMigrations::ReadSchemaVersion(
@@ -356,6 +441,14 @@ void LevelDbMigrations::RunMigrations(leveldb::DB* db,
   if (from_version < 6 && to_version >= 6) {
     EnsureCollectionParentsIndex(db);
   }
+
+  if (from_version < 7 && to_version >= 7) {
+    EnsureCollectionGroupDocumentsIndex(db);
+  }
+
+  if (from_version < 8 && to_version >= 8) {
+    DropTargetStates(db);
+  }
 }
 
 }  // namespace local
@@ -119,6 +119,12 @@ void LevelDbRemoteDocumentCache::Add(const MaybeDocument& document,
       path.PopLast(), read_time, path.last_segment());
   db_->current_transaction()->Put(ldb_read_time_key, "");
 
+  std::string ldb_collection_group_key =
+      LevelDbCollectionGroupDocumentKey::Key(key);
+  db_->current_transaction()->Put(
+      ldb_collection_group_key,
+      LevelDbCollectionGroupDocumentKey::EncodeReadTimeValue(read_time));
+
   db_->index_manager()->AddToCollectionParentIndex(
       document.key().path().PopLast());
 }
@@ -126,6 +132,10 @@ void LevelDbRemoteDocumentCache::Add(const MaybeDocument& document,
 void LevelDbRemoteDocumentCache::Remove(const DocumentKey& key) {
   std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
   db_->current_transaction()->Delete(ldb_key);
+
+  std::string ldb_collection_group_key =
+      LevelDbCollectionGroupDocumentKey::Key(key);
+  db_->current_transaction()->Delete(ldb_collection_group_key);
 }
 
 absl::optional<MaybeDocument> LevelDbRemoteDocumentCache::Get(
@@ -191,9 +201,9 @@ DocumentMap LevelDbRemoteDocumentCache::GetAllExisting(
 
 DocumentMap LevelDbRemoteDocumentCache::GetMatching(
     const Query& query, const SnapshotVersion& since_read_time) {
-  HARD_ASSERT(
-      !query.IsCollectionGroupQuery(),
-      "CollectionGroup queries should be handled in LocalDocumentsView");
+  if (query.IsCollectionGroupQuery()) {
+    return GetMatchingCollectionGroup(query, since_read_time);
+  }
 
   // Use the query path as a prefix for testing if a document matches the query.
   const ResourcePath& query_path = query.path();
@@ -271,6 +281,85 @@ DocumentMap LevelDbRemoteDocumentCache::GetMatching(
   }
 }
 
+DocumentMap LevelDbRemoteDocumentCache::GetMatchingCollectionGroup(
+    const Query& query, const SnapshotVersion& since_read_time) {
+  const std::string& collection_id = *query.collection_group();
+  const ResourcePath& query_path = query.path();
+
+  // All documents in collections with the given ID are adjacent in the
+  // collection group index, so a single range scan finds every candidate. The
+  // read time is stored in the row value, which lets us skip documents that
+  // have not changed since `since_read_time` without reading them.
+  std::string start_key =
+      LevelDbCollectionGroupDocumentKey::KeyPrefix(collection_id);
+  auto index_it = db_->current_transaction()->NewIterator();
+  index_it->Seek(start_key);
+
+  // Index rows are ordered by document key, just like the remote documents
+  // table, so the documents can be read with a second iterator that only moves
+  // forward. Documents in the same parent collection are usually adjacent in
+  // both tables, so try the next row before falling back to a seek.
+  auto document_it = db_->current_transaction()->NewIterator();
+  bool document_it_positioned = false;
+
+  BackgroundQueue tasks(executor_.get());
+  AsyncResults<Document> results;
+
+  LevelDbCollectionGroupDocumentKey current_key;
+  LevelDbRemoteDocumentKey document_row_key;
+  for (; index_it->Valid() && current_key.Decode(index_it->key());
+       index_it->Next()) {
+    if (current_key.collection_id() != collection_id) {
+      break;
+    }
+
+    const DocumentKey& document_key = current_key.document_key();
+    if (!query_path.IsPrefixOf(document_key.path())) {
+      continue;
+    }
+
+    if (since_read_time != SnapshotVersion::None()) {
+      SnapshotVersion read_time =
+          LevelDbCollectionGroupDocumentKey::DecodeReadTimeValue(
+              index_it->value());
+      if (read_time <= since_read_time) {
+        continue;
+      }
+    }
+
+    if (document_it_positioned) {
+      document_it->Next();
+    }
+    if (!document_it_positioned || !document_it->Valid() ||
+        !document_row_key.Decode(document_it->key()) ||
+        document_row_key.document_key() != document_key) {
+      document_it->Seek(LevelDbRemoteDocumentKey::Key(document_key));
+      document_it_positioned = true;
+      if (!document_it->Valid() ||
+          !document_row_key.Decode(document_it->key()) ||
+          document_row_key.document_key() != document_key) {
+        continue;
+      }
+    }
+
+    const std::string& contents = document_it->value();
+    tasks.Execute([this, &results, document_key, contents] {
+      MaybeDocument maybe_doc = DecodeMaybeDocument(contents, document_key);
+      if (maybe_doc.is_document()) {
+        results.Insert(Document(maybe_doc));
+      }
+    });
+  }
+
+  tasks.AwaitAll();
+
+  DocumentMap map;
+  for (const Document& doc : results.Result()) {
+    map = map.insert(doc.key(), doc);
+  }
+  return map;
+}
+
 MaybeDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
     absl::string_view encoded, const DocumentKey& key) {
   StringReader reader{encoded};
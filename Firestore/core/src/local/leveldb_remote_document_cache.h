@@ -64,6 +64,13 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
    */
   model::DocumentMap GetAllExisting(const model::DocumentKeySet& keys);
 
+  /**
+   * Executes a Collection Group query using the collection group documents
+   * index.
+   */
+  model::DocumentMap GetMatchingCollectionGroup(
+      const core::Query& query, const model::SnapshotVersion& since_read_time);
+
   model::MaybeDocument DecodeMaybeDocument(absl::string_view encoded,
                                            const model::DocumentKey& key);
 
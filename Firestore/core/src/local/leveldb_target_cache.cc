@@ -115,7 +115,8 @@ void LevelDbTargetCache::AddTarget(const TargetData& target_data) {
 }
 
 void LevelDbTargetCache::UpdateTarget(const TargetData& target_data) {
-  Save(target_data);
+  // The target itself never changes once added, so only write its state.
+  SaveState(target_data);
 
   if (UpdateMetadata(target_data)) {
     SaveMetadata();
@@ -129,6 +130,7 @@ void LevelDbTargetCache::RemoveTarget(const TargetData& target_data) {
 
   std::string key = LevelDbTargetKey::Key(target_id);
   db_->current_transaction()->Delete(key);
+  db_->current_transaction()->Delete(LevelDbTargetStateKey::Key(target_id));
 
   std::string index_key =
       LevelDbQueryTargetKey::Key(target_data.target().CanonicalId(), target_id);
@@ -182,7 +184,7 @@ absl::optional<TargetData> LevelDbTargetCache::GetTarget(const Target& target) {
     // actually equal to the requested target.
     TargetData target_data = DecodeTarget(target_iterator->value());
     if (target_data.target() == target) {
-      return target_data;
+      return ApplyState(target_data);
     }
   }
 
@@ -192,46 +194,35 @@ absl::optional<TargetData> LevelDbTargetCache::GetTarget(const Target& target) {
 void LevelDbTargetCache::EnumerateSequenceNumbers(
     const SequenceNumberCallback& callback) {
   // Enumerate all targets, give their sequence numbers.
-  std::string target_prefix = LevelDbTargetKey::KeyPrefix();
-  auto it = db_->current_transaction()->NewIterator();
-  it->Seek(target_prefix);
-  for (; it->Valid() && absl::StartsWith(it->key(), target_prefix);
-       it->Next()) {
-    StringReader reader{it->value()};
-    auto target_proto = DecodeTargetProto(&reader);
-    callback(target_proto->last_listen_sequence_number);
-  }
+  EnumerateTargetProtos(
+      [&](const firestore_client_Target&,
+          ListenSequenceNumber sequence_number) { callback(sequence_number); });
 }
 
 size_t LevelDbTargetCache::RemoveTargets(
     ListenSequenceNumber upper_bound,
     const std::unordered_map<model::TargetId, TargetData>& live_targets) {
-  std::string target_prefix = LevelDbTargetKey::KeyPrefix();
-  auto it = db_->current_transaction()->NewIterator();
-  it->Seek(target_prefix);
-
   std::unordered_set<TargetId> removed_targets;
 
   // In https://github.com/firebase/firebase-ios-sdk/issues/6721, a customer
   // reports that their client crashes when deserializing an invalid Target
   // during an LRU run. Instead of deserializing the value into a full Target
   // model, we only convert it into the underlying Protobuf message.
-  for (; it->Valid() && absl::StartsWith(it->key(), target_prefix);
-       it->Next()) {
-    StringReader reader{it->value()};
-    auto target_proto = DecodeTargetProto(&reader);
-    if (target_proto->last_listen_sequence_number <= upper_bound &&
-        live_targets.find(target_proto->target_id) == live_targets.end()) {
-      TargetId target_id = target_proto->target_id;
-
+  EnumerateTargetProtos([&](const firestore_client_Target& target_proto,
+                            ListenSequenceNumber sequence_number) {
+    TargetId target_id = target_proto.target_id;
+    if (sequence_number <= upper_bound &&
+        live_targets.find(target_id) == live_targets.end()) {
       // Remove the DocumentKey to TargetId mapping
       RemoveMatchingKeysForTarget(target_id);
-      // Remove the TargetId to Target mapping
-      db_->current_transaction()->Delete(it->key());
+      // Remove the TargetId to Target mapping, and the target's state
+      db_->current_transaction()->Delete(LevelDbTargetKey::Key(target_id));
+      db_->current_transaction()->Delete(
+          LevelDbTargetStateKey::Key(target_id));
 
       removed_targets.insert(target_id);
     }
-  }
+  });
 
   // Remove the CanonicalId to TargetId mapping
   RemoveQueryTargetKeyForTargets(removed_targets);
@@ -407,6 +398,84 @@ void LevelDbTargetCache::Save(const TargetData& target_data) {
                                   serializer_->EncodeTargetData(target_data));
 }
 
+void LevelDbTargetCache::SaveState(const TargetData& target_data) {
+  std::string key = LevelDbTargetStateKey::Key(target_data.target_id());
+  db_->current_transaction()->Put(key,
+                                  serializer_->EncodeTargetState(target_data));
+}
+
+absl::optional<Message<firestore_client_Target>>
+LevelDbTargetCache::ReadStateProto(TargetId target_id) {
+  std::string key = LevelDbTargetStateKey::Key(target_id);
+  std::string value;
+  Status status = db_->current_transaction()->Get(key, &value);
+  if (status.IsNotFound()) {
+    return absl::nullopt;
+  } else if (!status.ok()) {
+    HARD_FAIL("Fetch target state for target %s failed with status: %s",
+              target_id, status.ToString());
+  }
+
+  StringReader reader{value};
+  return DecodeTargetProto(&reader);
+}
+
+TargetData LevelDbTargetCache::ApplyState(const TargetData& target_data) {
+  auto state_proto = ReadStateProto(target_data.target_id());
+  if (!state_proto) {
+    return target_data;
+  }
+
+  StringReader reader;
+  TargetData result = serializer_->DecodeTargetState(
+      &reader, *state_proto.value(), target_data);
+  if (!reader.ok()) {
+    HARD_FAIL("Target state failed to parse: %s, message: %s",
+              reader.status().ToString(), state_proto->ToString());
+  }
+  return result;
+}
+
+void LevelDbTargetCache::EnumerateTargetProtos(
+    const TargetProtoCallback& callback) {
+  std::string target_prefix = LevelDbTargetKey::KeyPrefix();
+  auto target_iterator = db_->current_transaction()->NewIterator();
+  target_iterator->Seek(target_prefix);
+
+  auto state_iterator = db_->current_transaction()->NewIterator();
+  state_iterator->Seek(LevelDbTargetStateKey::KeyPrefix());
+
+  LevelDbTargetStateKey state_key;
+  for (; target_iterator->Valid() &&
+         absl::StartsWith(target_iterator->key(), target_prefix);
+       target_iterator->Next()) {
+    StringReader reader{target_iterator->value()};
+    auto target_proto = DecodeTargetProto(&reader);
+    TargetId target_id = target_proto->target_id;
+
+    // The state of this target, if any, is the first state at or after its
+    // target_id. Any states before it belong to no target, and are skipped.
+    bool has_state = false;
+    for (; state_iterator->Valid() && state_key.Decode(state_iterator->key());
+         state_iterator->Next()) {
+      if (state_key.target_id() >= target_id) {
+        has_state = state_key.target_id() == target_id;
+        break;
+      }
+    }
+
+    ListenSequenceNumber sequence_number =
+        target_proto->last_listen_sequence_number;
+    if (has_state) {
+      StringReader state_reader{state_iterator->value()};
+      auto state_proto = DecodeTargetProto(&state_reader);
+      sequence_number = state_proto->last_listen_sequence_number;
+    }
+
+    callback(*target_proto, sequence_number);
+  }
+}
+
 bool LevelDbTargetCache::UpdateMetadata(const TargetData& target_data) {
   bool updated = false;
   if (target_data.target_id() > metadata_->highest_target_id) {
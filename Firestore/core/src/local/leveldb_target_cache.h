@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TARGET_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TARGET_CACHE_H_
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -127,6 +128,39 @@ class LevelDbTargetCache : public TargetCache {
 
  private:
   void Save(const TargetData& target_data);
+
+  /**
+   * Writes the parts of the given target data that change while the target is
+   * listened to, apart from the target itself, which never changes.
+   */
+  void SaveState(const TargetData& target_data);
+
+  /**
+   * Reads the state written by `SaveState` for the given target, or returns
+   * `nullopt` if the target hasn't been updated since it was added.
+   */
+  absl::optional<nanopb::Message<firestore_client_Target>> ReadStateProto(
+      model::TargetId target_id);
+
+  /**
+   * Returns the given target data, decoded from the targets table, updated
+   * with the target's latest state.
+   */
+  TargetData ApplyState(const TargetData& target_data);
+
+  using TargetProtoCallback =
+      std::function<void(const firestore_client_Target& target_proto,
+                         model::ListenSequenceNumber sequence_number)>;
+
+  /**
+   * Calls `callback` with the proto of every target in the targets table,
+   * along with the target's latest sequence number.
+   *
+   * Targets and target states are both keyed by target_id, so this walks the
+   * two tables side by side rather than looking up each target's state.
+   */
+  void EnumerateTargetProtos(const TargetProtoCallback& callback);
+
   bool UpdateMetadata(const TargetData& target_data);
   void SaveMetadata();
 
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/mutation_queue.h"
@@ -28,6 +29,7 @@
 #include "Firestore/core/src/model/document_map.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/no_document.h"
+#include "Firestore/core/src/model/patch_mutation.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -47,6 +49,7 @@ using model::Mutation;
 using model::MutationBatch;
 using model::NoDocument;
 using model::OptionalMaybeDocumentMap;
+using model::PatchMutation;
 using model::ResourcePath;
 using model::SnapshotVersion;
 
@@ -138,30 +141,15 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingDocumentQuery(
   return result;
 }
 
-model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
+DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
     const Query& query, const SnapshotVersion& since_read_time) {
-  HARD_ASSERT(
-      query.path().empty(),
-      "Currently we only support collection group queries at the root.");
-
-  const std::string& collection_id = *query.collection_group();
-  std::vector<ResourcePath> parents =
-      index_manager_->GetCollectionParents(collection_id);
-  DocumentMap results;
-
-  // Perform a collection query against each parent that contains the
-  // collection_id and aggregate the results.
-  for (const ResourcePath& parent : parents) {
-    Query collection_query =
-        query.AsCollectionQueryAtPath(parent.Append(collection_id));
-    DocumentMap collection_results =
-        GetDocumentsMatchingCollectionQuery(collection_query, since_read_time);
-    for (const auto& kv : collection_results.underlying_map()) {
-      const DocumentKey& key = kv.first;
-      results = results.insert(key, Document(kv.second));
-    }
-  }
-  return results;
+  // The remote document cache resolves the whole collection group with a
+  // single index scan, so mutations only need to be overlaid once.
+  DocumentMap results =
+      remote_document_cache_->GetMatching(query, since_read_time);
+  std::vector<MutationBatch> batches = mutation_queue_->AllMutationBatches();
+
+  return ApplyMutationsToQueryResults(query, batches, std::move(results));
 }
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
@@ -172,29 +160,34 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
   std::vector<MutationBatch> matching_batches =
       mutation_queue_->AllMutationBatchesAffectingQuery(query);
 
-  results = AddMissingBaseDocuments(matching_batches, std::move(results));
-
-  for (const MutationBatch& batch : matching_batches) {
-    for (const Mutation& mutation : batch.mutations()) {
-      // Only process documents belonging to the collection.
-      if (!query.path().IsImmediateParentOf(mutation.key().path())) {
-        continue;
-      }
-
-      const DocumentKey& key = mutation.key();
-      // base_doc may be unset for the documents that weren't yet written to
-      // the backend.
-      absl::optional<MaybeDocument> base_doc =
-          results.underlying_map().get(key);
+  return ApplyMutationsToQueryResults(query, matching_batches,
+                                      std::move(results));
+}
 
-      absl::optional<MaybeDocument> mutated_doc =
-          mutation.ApplyToLocalView(base_doc, batch.local_write_time());
+DocumentMap LocalDocumentsView::ApplyMutationsToQueryResults(
+    const Query& query,
+    const std::vector<MutationBatch>& matching_batches,
+    DocumentMap results) {
+  MutationsByDocument mutations =
+      GroupMutationsByDocument(query, matching_batches);
+  results = AddMissingBaseDocuments(query, mutations, std::move(results));
+
+  for (const auto& entry : mutations) {
+    const DocumentKey& key = entry.first;
+
+    // The document may be unset for the documents that weren't yet written to
+    // the backend.
+    absl::optional<MaybeDocument> doc = results.underlying_map().get(key);
+    for (const auto& batch_and_mutation : entry.second) {
+      const MutationBatch& batch = *batch_and_mutation.first;
+      const Mutation& mutation = *batch_and_mutation.second;
+      doc = mutation.ApplyToLocalView(doc, batch.local_write_time());
+    }
 
-      if (mutated_doc && mutated_doc->is_document()) {
-        results = results.insert(key, Document(*mutated_doc));
-      } else {
-        results = results.erase(key);
-      }
+    if (doc && doc->is_document()) {
+      results = results.insert(key, Document(*doc));
+    } else {
+      results = results.erase(key);
     }
   }
 
@@ -214,16 +207,38 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
   return results;
 }
 
+LocalDocumentsView::MutationsByDocument
+LocalDocumentsView::GroupMutationsByDocument(
+    const Query& query, const std::vector<MutationBatch>& matching_batches) {
+  MutationsByDocument result;
+  for (const MutationBatch& batch : matching_batches) {
+    for (const Mutation& mutation : batch.mutations()) {
+      // Only process documents belonging to the collection (group).
+      if (IsInQueryPath(query, mutation.key())) {
+        result[mutation.key()].emplace_back(&batch, &mutation);
+      }
+    }
+  }
+  return result;
+}
+
 DocumentMap LocalDocumentsView::AddMissingBaseDocuments(
-    const std::vector<MutationBatch>& matching_batches,
+    const Query& query,
+    const MutationsByDocument& mutations,
     DocumentMap existing_docs) {
   DocumentKeySet missing_doc_keys;
-  for (const MutationBatch& batch : matching_batches) {
-    for (const Mutation& mutation : batch.mutations()) {
-      const DocumentKey& key = mutation.key();
+  for (const auto& entry : mutations) {
+    const DocumentKey& key = entry.first;
+    if (existing_docs.underlying_map().contains(key)) continue;
+
+    for (const auto& batch_and_mutation : entry.second) {
+      const Mutation& mutation = *batch_and_mutation.second;
+      // Patches that don't write any field the query filters or orders by
+      // can't change whether the document matches.
       if (mutation.type() == Mutation::Type::Patch &&
-          !existing_docs.underlying_map().contains(key)) {
+          query.MayBeAffectedBy(PatchMutation(mutation).WrittenFields())) {
         missing_doc_keys = missing_doc_keys.insert(key);
+        break;
       }
     }
   }
@@ -240,6 +255,15 @@ DocumentMap LocalDocumentsView::AddMissingBaseDocuments(
   return existing_docs;
 }
 
+bool LocalDocumentsView::IsInQueryPath(const Query& query,
+                                       const DocumentKey& key) {
+  if (query.IsCollectionGroupQuery()) {
+    return key.HasCollectionId(*query.collection_group()) &&
+           query.path().IsPrefixOf(key.path());
+  }
+  return query.path().IsImmediateParentOf(key.path());
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
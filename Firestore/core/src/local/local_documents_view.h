@@ -17,11 +17,14 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LOCAL_DOCUMENTS_VIEW_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LOCAL_DOCUMENTS_VIEW_H_
 
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Firestore/core/src/local/index_manager.h"
 #include "Firestore/core/src/local/mutation_queue.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -89,6 +92,16 @@ class LocalDocumentsView {
  private:
   friend class CountingQueryEngine;  // For testing
 
+  /**
+   * The mutations of each document, in the order of their batches, along with
+   * the batch each one belongs to.
+   */
+  using MutationsByDocument = std::unordered_map<
+      model::DocumentKey,
+      std::vector<
+          std::pair<const model::MutationBatch*, const model::Mutation*>>,
+      model::DocumentKeyHash>;
+
   /** Internal version of GetDocument that allows re-using batches. */
   absl::optional<model::MaybeDocument> GetDocument(
       const model::DocumentKey& key,
@@ -106,6 +119,10 @@ class LocalDocumentsView {
   model::DocumentMap GetDocumentsMatchingDocumentQuery(
       const model::ResourcePath& doc_path);
 
+  /**
+   * Queries the remote documents of all collections in the group and overlays
+   * mutations in a single pass.
+   */
   model::DocumentMap GetDocumentsMatchingCollectionGroupQuery(
       const core::Query& query, const model::SnapshotVersion& since_read_time);
 
@@ -113,6 +130,27 @@ class LocalDocumentsView {
   model::DocumentMap GetDocumentsMatchingCollectionQuery(
       const core::Query& query, const model::SnapshotVersion& since_read_time);
 
+  /**
+   * Overlays the mutations in `matching_batches` that affect documents in the
+   * query's collection (or collection group) onto `results`, and removes any
+   * documents that no longer match the query.
+   *
+   * The mutations are grouped by document first, so that each document is
+   * looked up and updated in `results` once, however many batches modify it.
+   */
+  model::DocumentMap ApplyMutationsToQueryResults(
+      const core::Query& query,
+      const std::vector<model::MutationBatch>& matching_batches,
+      model::DocumentMap results);
+
+  /**
+   * Groups the mutations in `matching_batches` that affect documents in the
+   * query's collection (or collection group) by document.
+   */
+  static MutationsByDocument GroupMutationsByDocument(
+      const core::Query& query,
+      const std::vector<model::MutationBatch>& matching_batches);
+
   /**
    * It is possible that a `PatchMutation` can make a document match a query,
    * even if the version in the `RemoteDocumentCache` is not a match yet
@@ -121,11 +159,24 @@ class LocalDocumentsView {
    * back fill them via `remote_document_cache_->GetAll`, otherwise those
    * `PatchMutation`s will be ignored because no base document can be found, and
    * lead to missing results for the query.
+   *
+   * Documents whose patches don't touch any field the query filters or orders
+   * by are not back filled: if the base document didn't match, the patched
+   * document won't either.
    */
   model::DocumentMap AddMissingBaseDocuments(
-      const std::vector<model::MutationBatch>& matching_batches,
+      const core::Query& query,
+      const MutationsByDocument& mutations,
       model::DocumentMap existing_docs);
 
+  /**
+   * Returns true if the document with the given key lives in the query's
+   * collection or, for Collection Group queries, in one of the group's
+   * collections.
+   */
+  static bool IsInQueryPath(const core::Query& query,
+                            const model::DocumentKey& key);
+
   RemoteDocumentCache* remote_document_cache() {
     return remote_document_cache_;
   }
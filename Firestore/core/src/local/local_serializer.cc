@@ -295,6 +295,52 @@ TargetData LocalSerializer::DecodeTargetData(
                     last_limbo_free_snapshot_version, std::move(resume_token));
 }
 
+Message<firestore_client_Target> LocalSerializer::EncodeTargetState(
+    const TargetData& target_data) const {
+  Message<firestore_client_Target> result;
+
+  result->target_id = target_data.target_id();
+  result->last_listen_sequence_number = target_data.sequence_number();
+  result->snapshot_version = rpc_serializer_.EncodeTimestamp(
+      target_data.snapshot_version().timestamp());
+  result->last_limbo_free_snapshot_version = rpc_serializer_.EncodeTimestamp(
+      target_data.last_limbo_free_snapshot_version().timestamp());
+
+  // Force a copy because pb_release would otherwise double-free.
+  result->resume_token =
+      nanopb::CopyBytesArray(target_data.resume_token().get());
+
+  return result;
+}
+
+TargetData LocalSerializer::DecodeTargetState(
+    Reader* reader,
+    const firestore_client_Target& proto,
+    const TargetData& target_data) const {
+  if (!reader->status().ok()) return target_data;
+
+  if (proto.target_id != target_data.target_id()) {
+    reader->Fail(StringFormat("Target state for target %s found for target %s",
+                              proto.target_id, target_data.target_id()));
+    return target_data;
+  }
+
+  model::ListenSequenceNumber sequence_number =
+      static_cast<model::ListenSequenceNumber>(
+          proto.last_listen_sequence_number);
+  SnapshotVersion version =
+      rpc_serializer_.DecodeVersion(reader->context(), proto.snapshot_version);
+  SnapshotVersion last_limbo_free_snapshot_version =
+      rpc_serializer_.DecodeVersion(reader->context(),
+                                    proto.last_limbo_free_snapshot_version);
+  ByteString resume_token(proto.resume_token);
+
+  if (!reader->status().ok()) return target_data;
+  return target_data.WithSequenceNumber(sequence_number)
+      .WithResumeToken(std::move(resume_token), version)
+      .WithLastLimboFreeSnapshotVersion(last_limbo_free_snapshot_version);
+}
+
 Message<firestore_client_WriteBatch> LocalSerializer::EncodeMutationBatch(
     const MutationBatch& mutation_batch) const {
   Message<firestore_client_WriteBatch> result;
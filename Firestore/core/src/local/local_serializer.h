@@ -111,6 +111,23 @@ class LocalSerializer {
   TargetData DecodeTargetData(nanopb::Reader* reader,
                               const firestore_client_Target& proto) const;
 
+  /**
+   * @brief Encodes the parts of a TargetData that change while the target is
+   * listened to (its resume token, snapshot versions and sequence number) as a
+   * ::firestore::proto::Target with no target type set, for local storage
+   * apart from the target itself.
+   */
+  nanopb::Message<firestore_client_Target> EncodeTargetState(
+      const TargetData& target_data) const;
+
+  /**
+   * @brief Returns the given TargetData updated with the state decoded from a
+   * nanopb proto produced by `EncodeTargetState`.
+   */
+  TargetData DecodeTargetState(nanopb::Reader* reader,
+                               const firestore_client_Target& proto,
+                               const TargetData& target_data) const;
+
   /**
    * @brief Encodes a MutationBatch to the equivalent nanopb proto, representing
    * a ::firestore::client::WriteBatch, for local storage in the mutation queue.
@@ -16,7 +16,9 @@
 
 #include "Firestore/core/src/local/local_store.h"
 
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "Firestore/core/src/local/bundle_cache.h"
@@ -29,6 +31,8 @@
 #include "Firestore/core/src/local/query_result.h"
 #include "Firestore/core/src/local/reference_delegate.h"
 #include "Firestore/core/src/local/target_cache.h"
+#include "Firestore/core/src/model/field_mask.h"
+#include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/mutation_batch_result.h"
 #include "Firestore/core/src/model/patch_mutation.h"
@@ -47,10 +51,14 @@ using core::Target;
 using core::TargetIdGenerator;
 using model::BatchId;
 using model::DocumentKey;
+using model::DocumentKeyHash;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentUpdateMap;
 using model::DocumentVersionMap;
+using model::FieldMask;
+using model::FieldMaskMap;
+using model::FieldPath;
 using model::ListenSequenceNumber;
 using model::MaybeDocument;
 using model::MaybeDocumentMap;
@@ -183,19 +191,56 @@ LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
         local_write_time, std::move(base_mutations), std::move(mutations));
     MaybeDocumentMap changed_documents =
         batch.ApplyToLocalDocumentSet(existing_documents);
-    return LocalWriteResult{batch.batch_id(), std::move(changed_documents)};
+    return LocalWriteResult{batch.batch_id(), std::move(changed_documents),
+                            ChangedFields(batch)};
   });
 }
 
+FieldMaskMap LocalStore::ChangedFields(const MutationBatch& batch) {
+  // Base mutations only write fields that the batch transforms, so they can
+  // be ignored.
+  std::unordered_map<DocumentKey, std::set<FieldPath>, DocumentKeyHash> fields;
+  DocumentKeySet overwritten_keys;
+  for (const Mutation& mutation : batch.mutations()) {
+    if (mutation.type() != Mutation::Type::Patch) {
+      overwritten_keys = overwritten_keys.insert(mutation.key());
+      continue;
+    }
+    FieldMask written_fields = PatchMutation(mutation).WrittenFields();
+    fields[mutation.key()].insert(written_fields.begin(),
+                                  written_fields.end());
+  }
+
+  FieldMaskMap result;
+  for (auto& entry : fields) {
+    if (!overwritten_keys.contains(entry.first)) {
+      result.emplace(entry.first, FieldMask(std::move(entry.second)));
+    }
+  }
+  return result;
+}
+
 MaybeDocumentMap LocalStore::AcknowledgeBatch(
     const MutationBatchResult& batch_result) {
-  return persistence_->Run("Acknowledge batch", [&] {
-    const MutationBatch& batch = batch_result.batch();
-    mutation_queue_->AcknowledgeBatch(batch, batch_result.stream_token());
-    ApplyBatchResult(batch_result);
+  return AcknowledgeBatches({batch_result});
+}
+
+MaybeDocumentMap LocalStore::AcknowledgeBatches(
+    const std::vector<MutationBatchResult>& batch_results) {
+  return persistence_->Run("Acknowledge batches", [&] {
+    DocumentKeySet affected_keys;
+    for (const MutationBatchResult& batch_result : batch_results) {
+      const MutationBatch& batch = batch_result.batch();
+      mutation_queue_->AcknowledgeBatch(batch, batch_result.stream_token());
+      ApplyBatchResult(batch_result);
+
+      for (const DocumentKey& key : batch.keys()) {
+        affected_keys = affected_keys.insert(key);
+      }
+    }
     mutation_queue_->PerformConsistencyCheck();
 
-    return local_documents_->GetDocuments(batch.keys());
+    return local_documents_->GetDocuments(affected_keys);
   });
 }
 
@@ -149,6 +149,19 @@ class LocalStore : public bundle::BundleCallback {
   model::MaybeDocumentMap AcknowledgeBatch(
       const model::MutationBatchResult& batch_result);
 
+  /**
+   * Acknowledges the given batches, which must be the oldest batches in the
+   * mutation queue, in order.
+   *
+   * Equivalent to calling `AcknowledgeBatch` for each batch, except that all
+   * the batches are acknowledged in a single transaction and the latency
+   * compensated view of the union of their documents is recalculated once.
+   *
+   * @return The resulting (modified) documents.
+   */
+  model::MaybeDocumentMap AcknowledgeBatches(
+      const std::vector<model::MutationBatchResult>& batch_results);
+
   /**
    * Removes mutations from the MutationQueue for the specified batch.
    * LocalDocuments will be recalculated.
@@ -279,6 +292,12 @@ class LocalStore : public bundle::BundleCallback {
   void StartMutationQueue();
   void ApplyBatchResult(const model::MutationBatchResult& batch_result);
 
+  /**
+   * Returns the fields that the given batch may change in each of the
+   * documents that it only patches.
+   */
+  static model::FieldMaskMap ChangedFields(const model::MutationBatch& batch);
+
   /**
    * Returns true if the new_target_data should be persisted during an update of
    * an active target. TargetData should always be persisted when a target is
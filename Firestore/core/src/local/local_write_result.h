@@ -20,6 +20,9 @@
 #include <utility>
 
 #include "Firestore/core/src/model/document_map.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/field_mask.h"
+#include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/types.h"
 
 namespace firebase {
@@ -33,6 +36,14 @@ class LocalWriteResult {
       : batch_id_(batch_id), changes_(std::move(changes)) {
   }
 
+  LocalWriteResult(model::BatchId batch_id,
+                   model::MaybeDocumentMap&& changes,
+                   model::FieldMaskMap&& changed_fields)
+      : batch_id_(batch_id),
+        changes_(std::move(changes)),
+        changed_fields_(std::move(changed_fields)) {
+  }
+
   LocalWriteResult() = default;
 
   /** The batch ID of the local write. */
@@ -45,9 +56,19 @@ class LocalWriteResult {
     return changes_;
   }
 
+  /**
+   * For the changed documents that the local write only patched, the fields
+   * that may have changed. Any field of the other changed documents may have
+   * changed.
+   */
+  const model::FieldMaskMap& changed_fields() const {
+    return changed_fields_;
+  }
+
  private:
   model::BatchId batch_id_;
   model::MaybeDocumentMap changes_;
+  model::FieldMaskMap changed_fields_;
 };
 
 }  // namespace local
@@ -16,7 +16,7 @@
 
 #include "Firestore/core/src/local/memory_lru_reference_delegate.h"
 
-#include <vector>
+#include <utility>
 
 #include "Firestore/core/src/local/listen_sequence.h"
 #include "Firestore/core/src/local/lru_garbage_collector.h"
@@ -75,7 +75,7 @@ void MemoryLruReferenceDelegate::RemoveTarget(const TargetData& target_data) {
 
 void MemoryLruReferenceDelegate::UpdateLimboDocument(
     const model::DocumentKey& key) {
-  sequence_numbers_[key] = current_sequence_number_;
+  UpdateSequenceNumber(key);
 }
 
 void MemoryLruReferenceDelegate::OnTransactionStarted(absl::string_view) {
@@ -93,9 +93,9 @@ void MemoryLruReferenceDelegate::EnumerateTargetSequenceNumbers(
 
 void MemoryLruReferenceDelegate::EnumerateOrphanedDocuments(
     const OrphanedDocumentCallback& callback) {
-  for (const auto& entry : sequence_numbers_) {
-    const DocumentKey& key = entry.first;
-    ListenSequenceNumber sequence_number = entry.second;
+  for (const auto& entry : documents_by_sequence_number_) {
+    ListenSequenceNumber sequence_number = entry.first;
+    const DocumentKey& key = entry.second;
     // Pass in the exact sequence number as the upper bound so we know it won't
     // be pinned by being too recent.
     if (!IsPinnedAtSequenceNumber(sequence_number, key)) {
@@ -122,21 +122,36 @@ int MemoryLruReferenceDelegate::RemoveTargets(
 
 int MemoryLruReferenceDelegate::RemoveOrphanedDocuments(
     model::ListenSequenceNumber upper_bound) {
-  std::vector<DocumentKey> removed =
-      persistence_->remote_document_cache()->RemoveOrphanedDocuments(
-          this, upper_bound);
-  for (const auto& key : removed) {
+  MemoryRemoteDocumentCache* cache = persistence_->remote_document_cache();
+  int removed = 0;
+
+  // Documents are ordered by the sequence number at which they were last used,
+  // so the scan can stop at the first document that is too recent to collect.
+  auto it = documents_by_sequence_number_.begin();
+  while (it != documents_by_sequence_number_.end() &&
+         it->first <= upper_bound) {
+    const DocumentKey& key = it->second;
+    if (IsPinnedAtSequenceNumber(upper_bound, key)) {
+      ++it;
+      continue;
+    }
+
+    if (cache->Get(key)) {
+      cache->Remove(key);
+      ++removed;
+    }
     sequence_numbers_.erase(key);
+    it = documents_by_sequence_number_.erase(it);
   }
-  return static_cast<int>(removed.size());
+  return removed;
 }
 
 void MemoryLruReferenceDelegate::AddReference(const DocumentKey& key) {
-  sequence_numbers_[key] = current_sequence_number_;
+  UpdateSequenceNumber(key);
 }
 
 void MemoryLruReferenceDelegate::RemoveReference(const DocumentKey& key) {
-  sequence_numbers_[key] = current_sequence_number_;
+  UpdateSequenceNumber(key);
 }
 
 bool MemoryLruReferenceDelegate::MutationQueuesContainKey(
@@ -152,7 +167,18 @@ bool MemoryLruReferenceDelegate::MutationQueuesContainKey(
 
 void MemoryLruReferenceDelegate::RemoveMutationReference(
     const DocumentKey& key) {
-  sequence_numbers_[key] = current_sequence_number_;
+  UpdateSequenceNumber(key);
+}
+
+void MemoryLruReferenceDelegate::UpdateSequenceNumber(const DocumentKey& key) {
+  auto it = sequence_numbers_.find(key);
+  if (it == sequence_numbers_.end()) {
+    sequence_numbers_.emplace(key, current_sequence_number_);
+  } else {
+    documents_by_sequence_number_.erase(std::make_pair(it->second, key));
+    it->second = current_sequence_number_;
+  }
+  documents_by_sequence_number_.emplace(current_sequence_number_, key);
 }
 
 bool MemoryLruReferenceDelegate::IsPinnedAtSequenceNumber(
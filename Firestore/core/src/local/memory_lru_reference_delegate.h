@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_LOCAL_MEMORY_LRU_REFERENCE_DELEGATE_H_
 
 #include <memory>
+#include <set>
 #include <unordered_map>
 #include <utility>
 
@@ -80,6 +81,12 @@ class MemoryLruReferenceDelegate : public LruDelegate {
  private:
   bool MutationQueuesContainKey(const model::DocumentKey& key) const;
 
+  /**
+   * Records that the document with the given key was used at the current
+   * sequence number.
+   */
+  void UpdateSequenceNumber(const model::DocumentKey& key);
+
   // This instance is owned by MemoryPersistence.
   MemoryPersistence* persistence_ = nullptr;
 
@@ -94,6 +101,12 @@ class MemoryLruReferenceDelegate : public LruDelegate {
                      model::DocumentKeyHash>
       sequence_numbers_;
 
+  // The entries of `sequence_numbers_`, ordered by sequence number. Garbage
+  // collection only needs to visit documents that were last used at or before
+  // its upper bound, which come first in this order.
+  std::set<std::pair<model::ListenSequenceNumber, model::DocumentKey>>
+      documents_by_sequence_number_;
+
   // This ReferenceSet is owned by LocalStore.
   ReferenceSet* additional_references_ = nullptr;
 
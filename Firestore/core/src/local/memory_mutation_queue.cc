@@ -94,13 +94,16 @@ MutationBatch MemoryMutationQueue::AddMutationBatch(
                       std::move(mutations));
   queue_.push_back(batch);
 
-  // Track references by document key and index collection parents.
+  // Track references by document key and collection, and index collection
+  // parents.
   for (const Mutation& mutation : batch.mutations()) {
     batches_by_document_key_ = batches_by_document_key_.insert(
         DocumentKeyReference{mutation.key(), batch_id});
 
-    persistence_->index_manager()->AddToCollectionParentIndex(
-        mutation.key().path().PopLast());
+    ResourcePath collection_path = mutation.key().path().PopLast();
+    batches_by_collection_[collection_path].insert(batch_id);
+
+    persistence_->index_manager()->AddToCollectionParentIndex(collection_path);
   }
 
   return batch;
@@ -113,15 +116,23 @@ void MemoryMutationQueue::RemoveMutationBatch(const MutationBatch& batch) {
   HARD_ASSERT(head.batch_id() == batch.batch_id(),
               "Can only remove the first entry of the mutation queue");
 
-  queue_.erase(queue_.begin());
+  queue_.pop_front();
 
-  // Remove entries from the index too.
+  // Remove entries from the indexes too.
   for (const Mutation& mutation : batch.mutations()) {
     const DocumentKey& key = mutation.key();
     persistence_->reference_delegate()->RemoveMutationReference(key);
 
     DocumentKeyReference reference{key, batch.batch_id()};
     batches_by_document_key_ = batches_by_document_key_.erase(reference);
+
+    auto collection = batches_by_collection_.find(key.path().PopLast());
+    if (collection != batches_by_collection_.end()) {
+      collection->second.erase(batch.batch_id());
+      if (collection->second.empty()) {
+        batches_by_collection_.erase(collection);
+      }
+    }
   }
 }
 
@@ -166,42 +177,17 @@ MemoryMutationQueue::AllMutationBatchesAffectingQuery(const Query& query) {
       !query.IsCollectionGroupQuery(),
       "CollectionGroup queries should be handled in LocalDocumentsView");
 
-  // Use the query path as a prefix for testing if a document matches the query.
-  const ResourcePath& prefix = query.path();
-  size_t immediate_children_path_length = prefix.size() + 1;
-
-  // Construct a document reference for actually scanning the index. Unlike the
-  // prefix, the document key in this reference must have an even number of
-  // segments. The empty segment can be used as a suffix of the query path
-  // because it precedes all other segments in an ordered traversal.
-  ResourcePath start_path = query.path();
-  if (!DocumentKey::IsDocumentKey(start_path)) {
-    start_path = start_path.Append("");
-  }
-  DocumentKeyReference start{DocumentKey{start_path}, 0};
-
-  // Find unique batch_ids referenced by all documents potentially matching the
-  // query.
-  std::set<BatchId> unique_batch_ids;
-  for (const auto& reference : batches_by_document_key_.values_from(start)) {
-    const ResourcePath& row_key_path = reference.key().path();
-    if (!prefix.IsPrefixOf(row_key_path)) {
-      break;
-    }
-
-    // Rows with document keys more than one segment longer than the query path
-    // can't be matches. For example, a query on 'rooms' can't match the
-    // document /rooms/abc/messages/xyx.
-    // TODO(mcg): we'll need a different scanner when we implement ancestor
-    // queries.
-    if (row_key_path.size() != immediate_children_path_length) {
-      continue;
-    }
-
-    unique_batch_ids.insert(reference.ref_id());
+  // Only batches that mutate direct children of the query path can affect the
+  // query. For example, a query on 'rooms' can't match the document
+  // /rooms/abc/messages/xyx.
+  // TODO(mcg): we'll need a different index when we implement ancestor
+  // queries.
+  auto found = batches_by_collection_.find(query.path());
+  if (found == batches_by_collection_.end()) {
+    return {};
   }
 
-  return AllMutationBatchesWithIds(unique_batch_ids);
+  return AllMutationBatchesWithIds(found->second);
 }
 
 absl::optional<MutationBatch>
@@ -244,6 +230,9 @@ void MemoryMutationQueue::PerformConsistencyCheck() {
     HARD_ASSERT(batches_by_document_key_.empty(),
                 "Document leak -- detected dangling mutation references when "
                 "queue is empty.");
+    HARD_ASSERT(batches_by_collection_.empty(),
+                "Collection leak -- detected dangling mutation references "
+                "when queue is empty.");
   }
 }
 
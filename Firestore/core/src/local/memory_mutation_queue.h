@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_MEMORY_MUTATION_QUEUE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_MEMORY_MUTATION_QUEUE_H_
 
+#include <deque>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -26,6 +28,7 @@
 #include "Firestore/core/src/local/mutation_queue.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
 
@@ -55,7 +58,7 @@ class MemoryMutationQueue : public MutationQueue {
   void RemoveMutationBatch(const model::MutationBatch& batch) override;
 
   std::vector<model::MutationBatch> AllMutationBatches() override {
-    return queue_;
+    return {queue_.begin(), queue_.end()};
   }
 
   std::vector<model::MutationBatch> AllMutationBatchesAffectingDocumentKeys(
@@ -122,8 +125,11 @@ class MemoryMutationQueue : public MutationQueue {
    *
    * Once the held write acknowledgements become visible they are removed from
    * the head of the queue along with any tombstones that follow.
+   *
+   * A deque allows removing from the head in constant time while still
+   * supporting constant time lookups by index (see `IndexOfBatchId`).
    */
-  std::vector<model::MutationBatch> queue_;
+  std::deque<model::MutationBatch> queue_;
 
   /**
    * The next value to use when assigning sequential IDs to each mutation
@@ -140,6 +146,13 @@ class MemoryMutationQueue : public MutationQueue {
 
   /** An ordered mapping between documents and the mutation batch IDs. */
   DocumentKeyReferenceSet batches_by_document_key_;
+
+  /**
+   * The IDs of the batches that mutate documents directly within each
+   * collection, keyed by collection path.
+   */
+  std::map<model::ResourcePath, std::set<model::BatchId>>
+      batches_by_collection_;
 };
 
 }  // namespace local
@@ -16,8 +16,11 @@
 
 #include "Firestore/core/src/local/memory_remote_document_cache.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "Firestore/core/src/core/query.h"
-#include "Firestore/core/src/local/memory_lru_reference_delegate.h"
 #include "Firestore/core/src/local/memory_persistence.h"
 #include "Firestore/core/src/local/sizer.h"
 #include "Firestore/core/src/model/document_map.h"
@@ -32,12 +35,30 @@ using model::Document;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
-using model::ListenSequenceNumber;
 using model::MaybeDocument;
 using model::MaybeDocumentMap;
 using model::OptionalMaybeDocumentMap;
+using model::ResourcePath;
 using model::SnapshotVersion;
 
+namespace {
+
+/**
+ * Returns true if looking up `num_keys` keys in a cache of `cache_size`
+ * documents is cheaper as a merge-join over the whole cache than as a tree
+ * lookup per key. A lookup costs about log2(cache_size) comparisons while the
+ * merge-join visits every document once.
+ */
+bool ShouldMergeJoin(size_t num_keys, size_t cache_size) {
+  size_t depth = 1;
+  for (size_t n = cache_size; n > 1; n >>= 1) {
+    ++depth;
+  }
+  return cache_size <= num_keys * depth;
+}
+
+}  // namespace
+
 MemoryRemoteDocumentCache::MemoryRemoteDocumentCache(
     MemoryPersistence* persistence) {
   persistence_ = persistence;
@@ -45,13 +66,30 @@ MemoryRemoteDocumentCache::MemoryRemoteDocumentCache(
 
 void MemoryRemoteDocumentCache::Add(const MaybeDocument& document,
                                     const model::SnapshotVersion& read_time) {
-  docs_ = docs_.insert(document.key(), std::make_pair(document, read_time));
+  const DocumentKey& key = document.key();
+  const auto& existing = docs_.get(key);
+  if (existing) {
+    RemoveFromCollection(key, existing->second);
+  }
 
-  persistence_->index_manager()->AddToCollectionParentIndex(
-      document.key().path().PopLast());
+  docs_ = docs_.insert(key, std::make_pair(document, read_time));
+
+  ResourcePath collection_path = key.path().PopLast();
+  if (document.is_document()) {
+    CollectionDocuments& collection = collections_[collection_path];
+    collection.documents.emplace(key, Document(document));
+    collection.by_read_time.emplace(read_time, key);
+  }
+
+  persistence_->index_manager()->AddToCollectionParentIndex(collection_path);
 }
 
 void MemoryRemoteDocumentCache::Remove(const DocumentKey& key) {
+  const auto& existing = docs_.get(key);
+  if (existing) {
+    RemoveFromCollection(key, existing->second);
+  }
+
   docs_ = docs_.erase(key);
 }
 
@@ -63,64 +101,108 @@ absl::optional<MaybeDocument> MemoryRemoteDocumentCache::Get(
 
 OptionalMaybeDocumentMap MemoryRemoteDocumentCache::GetAll(
     const DocumentKeySet& keys) {
-  OptionalMaybeDocumentMap results;
-  for (const DocumentKey& key : keys) {
-    // Make sure each key has a corresponding entry, which is nullopt in case
-    // the document is not found.
-    // TODO(http://b/32275378): Don't conflate missing / deleted.
-    results = results.insert(key, Get(key));
+  // Make sure each key has a corresponding entry, which is nullopt in case
+  // the document is not found.
+  // TODO(http://b/32275378): Don't conflate missing / deleted.
+  std::vector<std::pair<DocumentKey, absl::optional<MaybeDocument>>> entries;
+  entries.reserve(keys.size());
+
+  if (ShouldMergeJoin(keys.size(), docs_.size())) {
+    // Both `keys` and `docs_` are sorted by key, so a single pass over both
+    // finds every match.
+    auto doc = docs_.begin();
+    auto docs_end = docs_.end();
+    for (const DocumentKey& key : keys) {
+      while (doc != docs_end && doc->first < key) {
+        ++doc;
+      }
+      if (doc != docs_end && doc->first == key) {
+        entries.emplace_back(key, doc->second.first);
+      } else {
+        entries.emplace_back(key, absl::nullopt);
+      }
+    }
+  } else {
+    for (const DocumentKey& key : keys) {
+      entries.emplace_back(key, Get(key));
+    }
   }
-  return results;
+
+  // `entries` is in key order, so the result can be built in one pass.
+  return OptionalMaybeDocumentMap::CreateFromSorted(entries);
 }
 
 DocumentMap MemoryRemoteDocumentCache::GetMatching(
     const Query& query, const SnapshotVersion& since_read_time) {
-  HARD_ASSERT(
-      !query.IsCollectionGroupQuery(),
-      "CollectionGroup queries should be handled in LocalDocumentsView");
-
   DocumentMap results;
 
-  // Documents are ordered by key, so we can use a prefix scan to narrow down
-  // the documents we need to match the query against.
-  DocumentKey prefix{query.path().Append("")};
-  for (auto it = docs_.lower_bound(prefix); it != docs_.end(); ++it) {
-    const DocumentKey& key = it->first;
-    if (!query.path().IsPrefixOf(key.path())) {
-      break;
+  if (query.IsCollectionGroupQuery()) {
+    // Scan each collection with the group's ID. `query.Matches()` filters out
+    // collections that don't lie under the query's path.
+    const std::string& collection_id = *query.collection_group();
+    std::vector<ResourcePath> parents =
+        persistence_->index_manager()->GetCollectionParents(collection_id);
+    for (const ResourcePath& parent : parents) {
+      results = ScanCollection(query, parent.Append(collection_id),
+                               since_read_time, results);
     }
-    const MaybeDocument& maybe_doc = it->second.first;
-    if (!maybe_doc.is_document()) {
-      continue;
+    return results;
+  }
+
+  return ScanCollection(query, query.path(), since_read_time, results);
+}
+
+DocumentMap MemoryRemoteDocumentCache::ScanCollection(
+    const Query& query,
+    const ResourcePath& collection_path,
+    const SnapshotVersion& since_read_time,
+    DocumentMap results) const {
+  auto found = collections_.find(collection_path);
+  if (found == collections_.end()) {
+    return results;
+  }
+  const CollectionDocuments& collection = found->second;
+
+  if (since_read_time == SnapshotVersion::None()) {
+    for (const auto& kv : collection.documents) {
+      if (query.Matches(kv.second)) {
+        results = results.insert(kv.first, kv.second);
+      }
     }
+    return results;
+  }
 
-    const SnapshotVersion& read_time = it->second.second;
-    if (read_time <= since_read_time) {
+  // Only visit the documents that have been read since `since_read_time`. The
+  // empty key sorts before all others, so this is the first entry read at or
+  // after `since_read_time`.
+  auto it = collection.by_read_time.lower_bound(
+      std::make_pair(since_read_time, DocumentKey{}));
+  for (; it != collection.by_read_time.end(); ++it) {
+    if (it->first == since_read_time) {
       continue;
     }
 
-    Document doc(maybe_doc);
+    const Document& doc = collection.documents.at(it->second);
     if (query.Matches(doc)) {
-      results = results.insert(key, std::move(doc));
+      results = results.insert(doc.key(), doc);
     }
   }
   return results;
 }
 
-std::vector<DocumentKey> MemoryRemoteDocumentCache::RemoveOrphanedDocuments(
-    MemoryLruReferenceDelegate* reference_delegate,
-    ListenSequenceNumber upper_bound) {
-  std::vector<DocumentKey> removed;
-  auto updated_docs = docs_;
-  for (const auto& kv : docs_) {
-    const DocumentKey& key = kv.first;
-    if (!reference_delegate->IsPinnedAtSequenceNumber(upper_bound, key)) {
-      updated_docs = updated_docs.erase(key);
-      removed.push_back(key);
-    }
+void MemoryRemoteDocumentCache::RemoveFromCollection(
+    const DocumentKey& key, const SnapshotVersion& read_time) {
+  auto found = collections_.find(key.path().PopLast());
+  if (found == collections_.end()) {
+    return;
+  }
+
+  CollectionDocuments& collection = found->second;
+  collection.documents.erase(key);
+  collection.by_read_time.erase(std::make_pair(read_time, key));
+  if (collection.documents.empty()) {
+    collections_.erase(found);
   }
-  docs_ = updated_docs;
-  return removed;
 }
 
 int64_t MemoryRemoteDocumentCache::CalculateByteSize(const Sizer& sizer) {
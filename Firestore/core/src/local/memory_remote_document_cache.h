@@ -17,21 +17,22 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_MEMORY_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_MEMORY_REMOTE_DOCUMENT_CACHE_H_
 
+#include <map>
+#include <set>
 #include <utility>
-#include <vector>
 
 #include "Firestore/core/src/immutable/sorted_map.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/maybe_document.h"
 #include "Firestore/core/src/model/model_fwd.h"
-#include "Firestore/core/src/model/types.h"
+#include "Firestore/core/src/model/resource_path.h"
 
 namespace firebase {
 namespace firestore {
 namespace local {
 
-class MemoryLruReferenceDelegate;
 class MemoryPersistence;
 class Sizer;
 
@@ -51,18 +52,44 @@ class MemoryRemoteDocumentCache : public RemoteDocumentCache {
       const core::Query& query,
       const model::SnapshotVersion& since_read_time) override;
 
-  std::vector<model::DocumentKey> RemoveOrphanedDocuments(
-      MemoryLruReferenceDelegate* reference_delegate,
-      model::ListenSequenceNumber upper_bound);
-
   int64_t CalculateByteSize(const Sizer& sizer);
 
  private:
+  /**
+   * The existing documents of a single collection, indexed so that queries
+   * only visit the collection's direct children.
+   */
+  struct CollectionDocuments {
+    /** The collection's documents, ordered by key. */
+    std::map<model::DocumentKey, model::Document> documents;
+
+    /** The keys of `documents`, ordered by the time they were read. */
+    std::set<std::pair<model::SnapshotVersion, model::DocumentKey>>
+        by_read_time;
+  };
+
+  /**
+   * Adds the documents in the collection at `collection_path` that were read
+   * after `since_read_time` and match `query` to `results`.
+   */
+  model::DocumentMap ScanCollection(
+      const core::Query& query,
+      const model::ResourcePath& collection_path,
+      const model::SnapshotVersion& since_read_time,
+      model::DocumentMap results) const;
+
+  /** Removes the document with the given key from its collection's index. */
+  void RemoveFromCollection(const model::DocumentKey& key,
+                            const model::SnapshotVersion& read_time);
+
   /** Underlying cache of documents and their read times. */
   immutable::SortedMap<model::DocumentKey,
                        std::pair<model::MaybeDocument, model::SnapshotVersion>>
       docs_;
 
+  /** The existing documents in `docs_`, partitioned by collection path. */
+  std::map<model::ResourcePath, CollectionDocuments> collections_;
+
   // This instance is owned by MemoryPersistence; avoid a retain cycle.
   MemoryPersistence* persistence_;
 };
@@ -16,7 +16,7 @@
 
 #include "Firestore/core/src/local/memory_target_cache.h"
 
-#include <vector>
+#include <utility>
 
 #include "Firestore/core/src/local/memory_persistence.h"
 #include "Firestore/core/src/local/reference_delegate.h"
@@ -44,7 +44,18 @@ MemoryTargetCache::MemoryTargetCache(MemoryPersistence* persistence)
 }
 
 void MemoryTargetCache::AddTarget(const TargetData& target_data) {
-  targets_[target_data.target()] = target_data;
+  auto it = targets_.find(target_data.target());
+  if (it == targets_.end()) {
+    it = targets_.emplace(target_data.target(), target_data).first;
+  } else {
+    targets_by_sequence_number_.erase(std::make_pair(
+        it->second.sequence_number(), it->second.target_id()));
+    it->second = target_data;
+  }
+  targets_by_sequence_number_.emplace(
+      std::make_pair(target_data.sequence_number(), target_data.target_id()),
+      &it->first);
+
   if (target_data.target_id() > highest_target_id_) {
     highest_target_id_ = target_data.target_id();
   }
@@ -59,7 +70,12 @@ void MemoryTargetCache::UpdateTarget(const TargetData& target_data) {
 }
 
 void MemoryTargetCache::RemoveTarget(const TargetData& target_data) {
-  targets_.erase(target_data.target());
+  auto it = targets_.find(target_data.target());
+  if (it != targets_.end()) {
+    targets_by_sequence_number_.erase(std::make_pair(
+        it->second.sequence_number(), it->second.target_id()));
+    targets_.erase(it);
+  }
   references_.RemoveReferences(target_data.target_id());
 }
 
@@ -78,23 +94,25 @@ void MemoryTargetCache::EnumerateSequenceNumbers(
 size_t MemoryTargetCache::RemoveTargets(
     model::ListenSequenceNumber upper_bound,
     const std::unordered_map<TargetId, TargetData>& live_targets) {
-  std::vector<const Target*> to_remove;
-  for (const auto& kv : targets_) {
-    const Target& target = kv.first;
-    const TargetData& target_data = kv.second;
-
-    if (target_data.sequence_number() <= upper_bound) {
-      if (live_targets.find(target_data.target_id()) == live_targets.end()) {
-        to_remove.push_back(&target);
-        references_.RemoveReferences(target_data.target_id());
-      }
+  size_t removed = 0;
+
+  // Targets are ordered by sequence number, so the scan can stop at the first
+  // target that is too recent to collect.
+  auto it = targets_by_sequence_number_.begin();
+  while (it != targets_by_sequence_number_.end() &&
+         it->first.first <= upper_bound) {
+    TargetId target_id = it->first.second;
+    if (live_targets.find(target_id) != live_targets.end()) {
+      ++it;
+      continue;
     }
-  }
 
-  for (const Target* element : to_remove) {
-    targets_.erase(*element);
+    references_.RemoveReferences(target_id);
+    targets_.erase(targets_.find(*it->second));
+    it = targets_by_sequence_number_.erase(it);
+    ++removed;
   }
-  return to_remove.size();
+  return removed;
 }
 
 void MemoryTargetCache::AddMatchingKeys(const DocumentKeySet& keys,
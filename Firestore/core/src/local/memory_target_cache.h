@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_LOCAL_MEMORY_TARGET_CACHE_H_
 
 #include <cstdint>
+#include <map>
 #include <unordered_map>
 #include <utility>
 
@@ -102,6 +103,14 @@ class MemoryTargetCache : public TargetCache {
   /** Maps a target to the data about that query. */
   std::unordered_map<core::Target, TargetData> targets_;
 
+  /**
+   * The targets in `targets_`, ordered by sequence number (and target ID to
+   * break ties), so that garbage collection only visits eligible targets.
+   */
+  std::map<std::pair<model::ListenSequenceNumber, model::TargetId>,
+           const core::Target*>
+      targets_by_sequence_number_;
+
   /**
    * A ordered bidirectional mapping between documents and the remote target
    * IDs.
@@ -18,11 +18,15 @@
 
 #include <utility>
 
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/filter.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_value.h"
 #include "Firestore/core/src/model/maybe_document.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/util/log.h"
@@ -31,13 +35,17 @@ namespace firebase {
 namespace firestore {
 namespace local {
 
+using core::FieldFilter;
+using core::Filter;
 using core::LimitType;
 using core::Query;
 using core::Target;
 using model::Document;
+using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentSet;
+using model::FieldValue;
 using model::MaybeDocument;
 using model::MaybeDocumentMap;
 using model::SnapshotVersion;
@@ -48,6 +56,13 @@ DocumentMap QueryEngine::GetDocumentsMatchingQuery(
     const DocumentKeySet& remote_keys) {
   HARD_ASSERT(local_documents_view_, "SetLocalDocumentsView() not called");
 
+  // Queries that restrict the document key to a handful of values only need
+  // to look up those documents, no matter how large the collection is.
+  absl::optional<DocumentKeySet> candidate_keys = GetCandidateKeys(query);
+  if (candidate_keys) {
+    return ExecuteKeyLookup(query, *candidate_keys);
+  }
+
   // Queries that match all documents don't benefit from using key-based
   // lookups. It is more efficient to scan all documents in a collection, rather
   // than to perform individual lookups.
@@ -145,6 +160,54 @@ DocumentMap QueryEngine::ExecuteFullCollectionScan(const Query& query) {
       query, SnapshotVersion::None());
 }
 
+absl::optional<DocumentKeySet> QueryEngine::GetCandidateKeys(
+    const Query& query) const {
+  absl::optional<DocumentKeySet> result;
+
+  for (const Filter& filter : query.filters()) {
+    DocumentKeySet keys;
+    if (filter.type() == Filter::Type::kKeyFieldFilter) {
+      FieldFilter key_filter(filter);
+      if (key_filter.op() != Filter::Operator::Equal) continue;
+      keys = keys.insert(key_filter.value().reference_value().key());
+
+    } else if (filter.type() == Filter::Type::kKeyFieldInFilter) {
+      FieldFilter key_filter(filter);
+      for (const FieldValue& value : key_filter.value().array_value()) {
+        keys = keys.insert(value.reference_value().key());
+      }
+
+    } else {
+      continue;
+    }
+
+    if (!result || keys.size() < result->size()) {
+      result = std::move(keys);
+    }
+  }
+
+  return result;
+}
+
+DocumentMap QueryEngine::ExecuteKeyLookup(const Query& query,
+                                          const DocumentKeySet& keys) {
+  LOG_DEBUG("Using key lookup of %s documents to execute query: %s",
+            keys.size(), query.ToString());
+
+  DocumentMap results;
+  MaybeDocumentMap documents = local_documents_view_->GetDocuments(keys);
+  for (const auto& document_entry : documents) {
+    const MaybeDocument& maybe_doc = document_entry.second;
+    if (maybe_doc.is_document()) {
+      Document doc(maybe_doc);
+      if (query.Matches(doc)) {
+        results = results.insert(doc.key(), doc);
+      }
+    }
+  }
+  return results;
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
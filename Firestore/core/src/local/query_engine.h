@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_LOCAL_QUERY_ENGINE_H_
 
 #include "Firestore/core/src/model/model_fwd.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -46,6 +47,10 @@ class LocalDocumentsView;
  * - Limit queries where a document edit may cause the document to sort below
  *   another document that is in the local cache.
  * - Queries that have never been CURRENT or free of limbo documents.
+ *
+ * Queries that constrain the document key with an equality or IN filter are
+ * executed as point lookups of the candidate keys instead, regardless of
+ * whether they are eligible for Index-Free execution.
  */
 class QueryEngine {
  public:
@@ -92,6 +97,22 @@ class QueryEngine {
 
   model::DocumentMap ExecuteFullCollectionScan(const core::Query& query);
 
+  /**
+   * Returns the set of document keys that the query's key equality or IN
+   * filters restrict results to, or nullopt if the query has no such filter.
+   * If the query has several of them, the smallest set is returned: the
+   * remaining filters are still applied to the documents that are looked up.
+   */
+  absl::optional<model::DocumentKeySet> GetCandidateKeys(
+      const core::Query& query) const;
+
+  /**
+   * Executes the query by looking up each of the given candidate keys rather
+   * than scanning the query's collection.
+   */
+  model::DocumentMap ExecuteKeyLookup(const core::Query& query,
+                                      const model::DocumentKeySet& keys);
+
   LocalDocumentsView* local_documents_view_ = nullptr;
 };
 
@@ -16,9 +16,10 @@
 
 #include "Firestore/core/src/local/reference_set.h"
 
-#include "Firestore/core/src/immutable/sorted_set.h"
-#include "Firestore/core/src/local/document_key_reference.h"
+#include <utility>
+
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/document_key_set.h"
 
 namespace firebase {
 namespace firestore {
@@ -28,9 +29,10 @@ using model::DocumentKey;
 using model::DocumentKeySet;
 
 void ReferenceSet::AddReference(const DocumentKey& key, int id) {
-  DocumentKeyReference reference{key, id};
-  by_key_ = by_key_.insert(reference);
-  by_id_ = by_id_.insert(reference);
+  if (keys_by_id_[id].insert(key).second) {
+    ++counts_by_key_[key];
+    ++size_;
+  }
 }
 
 void ReferenceSet::AddReferences(const DocumentKeySet& keys, int id) {
@@ -40,7 +42,19 @@ void ReferenceSet::AddReferences(const DocumentKeySet& keys, int id) {
 }
 
 void ReferenceSet::RemoveReference(const DocumentKey& key, int id) {
-  RemoveReference(DocumentKeyReference{key, id});
+  auto found = keys_by_id_.find(id);
+  if (found == keys_by_id_.end()) {
+    return;
+  }
+
+  KeySet& keys = found->second;
+  if (keys.erase(key) == 0) {
+    return;
+  }
+  ReleaseKey(key);
+  if (keys.empty()) {
+    keys_by_id_.erase(found);
+  }
 }
 
 void ReferenceSet::RemoveReferences(
@@ -51,50 +65,50 @@ void ReferenceSet::RemoveReferences(
 }
 
 DocumentKeySet ReferenceSet::RemoveReferences(int id) {
-  DocumentKeyReference start{DocumentKey::Empty(), id};
-  DocumentKeyReference end{DocumentKey::Empty(), id + 1};
-
   DocumentKeySet removed{};
 
-  auto initial = by_id_;
-  for (const auto& reference : initial.values_in(start, end)) {
-    RemoveReference(reference);
-    removed = removed.insert(reference.key());
+  auto found = keys_by_id_.find(id);
+  if (found == keys_by_id_.end()) {
+    return removed;
+  }
+
+  KeySet keys = std::move(found->second);
+  keys_by_id_.erase(found);
+  for (const DocumentKey& key : keys) {
+    ReleaseKey(key);
+    removed = removed.insert(key);
   }
   return removed;
 }
 
 void ReferenceSet::RemoveAllReferences() {
-  auto initial = by_key_;
-  for (const DocumentKeyReference& reference : initial) {
-    RemoveReference(reference);
-  }
+  keys_by_id_.clear();
+  counts_by_key_.clear();
+  size_ = 0;
 }
 
-void ReferenceSet::RemoveReference(const DocumentKeyReference& reference) {
-  by_key_ = by_key_.erase(reference);
-  by_id_ = by_id_.erase(reference);
+void ReferenceSet::ReleaseKey(const DocumentKey& key) {
+  auto found = counts_by_key_.find(key);
+  if (--found->second == 0) {
+    counts_by_key_.erase(found);
+  }
+  --size_;
 }
 
 DocumentKeySet ReferenceSet::ReferencedKeys(int id) {
-  DocumentKeyReference start{DocumentKey::Empty(), id};
-  DocumentKeyReference end{DocumentKey::Empty(), id + 1};
-
   DocumentKeySet keys;
-  for (const auto& reference : by_id_.values_in(start, end)) {
-    keys = keys.insert(reference.key());
+
+  auto found = keys_by_id_.find(id);
+  if (found != keys_by_id_.end()) {
+    for (const DocumentKey& key : found->second) {
+      keys = keys.insert(key);
+    }
   }
   return keys;
 }
 
 bool ReferenceSet::ContainsKey(const DocumentKey& key) {
-  // Create a reference with a zero ID as the start position to find any
-  // document reference with this key.
-  DocumentKeyReference start{key, 0};
-
-  auto range = by_key_.values_from(start);
-  auto begin = range.begin();
-  return begin != range.end() && begin->key() == key;
+  return counts_by_key_.find(key) != counts_by_key_.end();
 }
 
 }  // namespace local
@@ -17,8 +17,10 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_REFERENCE_SET_H_
 #define FIRESTORE_CORE_SRC_LOCAL_REFERENCE_SET_H_
 
-#include "Firestore/core/src/immutable/sorted_set.h"
-#include "Firestore/core/src/local/document_key_reference.h"
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -30,25 +32,25 @@ namespace local {
  * (either a TargetId or BatchId). As references are added to or removed from
  * the set corresponding events are emitted to a registered garbage collector.
  *
- * Each reference is represented by a DocumentKeyReference object. Each of them
- * contains enough information to uniquely identify the reference. They are all
- * stored primarily in a set sorted by key. A document is considered garbage if
- * there's no references in that set (this can be efficiently checked thanks to
- * sorting by key).
+ * References are stored in two mutable hash indexes: the keys referenced by
+ * each Id, and the number of references to each key. A document is considered
+ * garbage if there are no references to its key, which can be checked with a
+ * single lookup. The index by Id is used to efficiently implement removal of
+ * all references by some TargetId.
  *
- * ReferenceSet also keeps a secondary set that contains references sorted by
- * Id. This one is used to efficiently implement removal of all references by
- * some TargetId.
+ * Unlike the indexes, the key sets returned from `ReferencedKeys` and
+ * `RemoveReferences` are immutable snapshots that are unaffected by later
+ * changes to the ReferenceSet.
  */
 class ReferenceSet {
  public:
   /** Returns true if the reference set contains no references. */
   bool empty() const {
-    return by_key_.empty();
+    return size_ == 0;
   }
 
   size_t size() const {
-    return by_key_.size();
+    return size_;
   }
 
   /** Adds a reference to the given document key for the given Id. */
@@ -80,11 +82,20 @@ class ReferenceSet {
   bool ContainsKey(const model::DocumentKey& key);
 
  private:
-  void RemoveReference(const DocumentKeyReference& reference);
+  using KeySet = std::unordered_set<model::DocumentKey, model::DocumentKeyHash>;
+
+  /** Decrements the reference count of the given key. */
+  void ReleaseKey(const model::DocumentKey& key);
+
+  /** The keys referenced by each Id. */
+  std::unordered_map<int, KeySet> keys_by_id_;
+
+  /** The number of Ids referencing each key. */
+  std::unordered_map<model::DocumentKey, size_t, model::DocumentKeyHash>
+      counts_by_key_;
 
-  immutable::SortedSet<DocumentKeyReference, DocumentKeyReference::ByKey>
-      by_key_;
-  immutable::SortedSet<DocumentKeyReference, DocumentKeyReference::ById> by_id_;
+  /** The total number of references. */
+  size_t size_ = 0;
 };
 
 }  // namespace local
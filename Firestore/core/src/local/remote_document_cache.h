@@ -76,7 +76,8 @@ class RemoteDocumentCache {
       const model::DocumentKeySet& keys) = 0;
 
   /**
-   * Executes a query against the cached Document entries
+   * Executes a query against the cached Document entries. Both collection
+   * and Collection Group queries are supported.
    *
    * Implementations may return extra documents if convenient. The results
    * should be re-filtered by the consumer before presenting them to the user.
@@ -134,6 +134,10 @@ absl::optional<FieldValue> Document::field(const FieldPath& path) const {
   return data().Get(path);
 }
 
+const FieldValue* Document::FindField(const FieldPath& path) const {
+  return data().Find(path);
+}
+
 DocumentState Document::document_state() const {
   return doc_rep().document_state_;
 }
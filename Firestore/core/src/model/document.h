@@ -113,6 +113,15 @@ class Document : public MaybeDocument {
 
   absl::optional<FieldValue> field(const FieldPath& path) const;
 
+  /**
+   * Returns a pointer to the value of the field at the given path or nullptr
+   * if the document doesn't contain it. The pointer remains valid for as long
+   * as this Document (or any copy of it) is alive.
+   *
+   * Prefer this to `field()` on hot paths, since it avoids copying the value.
+   */
+  const FieldValue* FindField(const FieldPath& path) const;
+
   DocumentState document_state() const;
 
   bool has_local_mutations() const;
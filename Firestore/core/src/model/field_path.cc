@@ -119,6 +119,24 @@ StatusOr<FieldPath> FieldPath::FromServerFormat(const std::string& path) {
 }
 
 StatusOr<FieldPath> FieldPath::FromServerFormatView(absl::string_view path) {
+  // Most paths contain no escapes, and are simply split on dots.
+  static constexpr char kSpecialCharacters[] = {'`', '\\', '\0'};
+  if (path.find_first_of(absl::string_view{kSpecialCharacters, 3}) ==
+      absl::string_view::npos) {
+    SegmentsT segments = absl::StrSplit(path, '.');
+    for (const std::string& segment : segments) {
+      if (segment.empty()) {
+        return Status{
+            Error::kErrorInvalidArgument,
+            StringFormat(
+                "Invalid field path (%s). Paths must not be empty, begin with "
+                "'.', end with '.', or contain '..'",
+                path)};
+      }
+    }
+    return FieldPath{std::move(segments)};
+  }
+
   SegmentsT segments;
   std::string segment;
   segment.reserve(path.size());
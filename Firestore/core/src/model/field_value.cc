@@ -17,6 +17,7 @@
 #include "Firestore/core/src/model/field_value.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <memory>
@@ -58,6 +59,38 @@ const T& Cast(const BaseValue& rep) {
   return static_cast<const T&>(rep);
 }
 
+/**
+ * Remembers the hash of an immutable container value so that it's computed at
+ * most once. Values can be shared between threads, so the cache is atomic.
+ * Zero marks a hash that hasn't been computed yet; a value whose hash really
+ * is zero just recomputes it each time.
+ */
+class CachedHash {
+ public:
+  template <typename F>
+  size_t Get(const F& compute) const {
+    size_t result = hash_.load(std::memory_order_relaxed);
+    if (result == 0) {
+      result = compute();
+      hash_.store(result, std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /**
+   * Returns true if both hashes have been computed and differ, which proves
+   * the values aren't equal without comparing their contents.
+   */
+  bool Differs(const CachedHash& other) const {
+    size_t lhs = hash_.load(std::memory_order_relaxed);
+    size_t rhs = other.hash_.load(std::memory_order_relaxed);
+    return lhs != 0 && rhs != 0 && lhs != rhs;
+  }
+
+ private:
+  mutable std::atomic<size_t> hash_{0};
+};
+
 class NullValue : public FieldValue::BaseValue {
  public:
   Type type() const override {
@@ -307,11 +340,8 @@ class ServerTimestampValue : public FieldValue::BaseValue {
   }
 
   size_t Hash() const override {
-    size_t result = TimestampInternal::Hash(value().local_write_time());
-    if (value().previous_value()) {
-      result = util::Hash(result, *value().previous_value());
-    }
-    return result;
+    // Only hash the local write time: Equals() ignores the previous value.
+    return TimestampInternal::Hash(value().local_write_time());
   }
 
   const ServerTimestamp& value() const {
@@ -438,6 +468,7 @@ class ArrayContents : public FieldValue::BaseValue {
     if (type() != other.type()) return false;
 
     auto& other_value = Cast<ArrayContents>(other);
+    if (hash_.Differs(other_value.hash_)) return false;
     return absl::c_equal(value_, other_value.value_);
   }
 
@@ -454,7 +485,7 @@ class ArrayContents : public FieldValue::BaseValue {
   }
 
   size_t Hash() const override {
-    return util::Hash(value_);
+    return hash_.Get([this] { return util::Hash(value_); });
   }
 
   const FieldValue::Array& value() const {
@@ -463,6 +494,7 @@ class ArrayContents : public FieldValue::BaseValue {
 
  private:
   FieldValue::Array value_;
+  CachedHash hash_;
 };
 
 class MapContents : public FieldValue::BaseValue {
@@ -478,6 +510,7 @@ class MapContents : public FieldValue::BaseValue {
     if (type() != other.type()) return false;
 
     auto& other_value = Cast<MapContents>(other);
+    if (hash_.Differs(other_value.hash_)) return false;
     return absl::c_equal(value_, other_value.value_);
   }
 
@@ -494,11 +527,13 @@ class MapContents : public FieldValue::BaseValue {
   }
 
   size_t Hash() const override {
-    size_t result = 0;
-    for (auto&& entry : value_) {
-      result = util::Hash(result, entry.first, entry.second);
-    }
-    return result;
+    return hash_.Get([this] {
+      size_t result = 0;
+      for (auto&& entry : value_) {
+        result = util::Hash(result, entry.first, entry.second);
+      }
+      return result;
+    });
   }
 
   const FieldValue::Map& value() const {
@@ -507,6 +542,7 @@ class MapContents : public FieldValue::BaseValue {
 
  private:
   FieldValue::Map value_;
+  CachedHash hash_;
 };
 
 }  // namespace
@@ -631,21 +667,29 @@ ObjectValue ObjectValue::Delete(const FieldPath& field_path) const {
 }
 
 absl::optional<FieldValue> ObjectValue::Get(const FieldPath& field_path) const {
+  const FieldValue* value = Find(field_path);
+  if (value == nullptr) {
+    return absl::nullopt;
+  }
+  return *value;
+}
+
+const FieldValue* ObjectValue::Find(const FieldPath& field_path) const {
   const FieldValue* current = &this->fv_;
   for (const auto& path : field_path) {
     if (current->type() != Type::Object) {
-      return absl::nullopt;
+      return nullptr;
     }
 
     const FieldValue::Map& entries = current->object_value();
     const auto iter = entries.find(path);
     if (iter == entries.end()) {
-      return absl::nullopt;
+      return nullptr;
     } else {
       current = &iter->second;
     }
   }
-  return *current;
+  return current;
 }
 
 FieldMask ObjectValue::ToFieldMask() const {
@@ -788,6 +832,9 @@ FieldValue FieldValue::FromMap(FieldValue::Map&& value) {
 }
 
 bool operator==(const FieldValue& lhs, const FieldValue& rhs) {
+  // Values are immutable and modified copies share unchanged subtrees, so
+  // identical reps are equal without visiting their contents.
+  if (lhs.rep_ == rhs.rep_) return true;
   return lhs.rep_->Equals(*rhs.rep_);
 }
 
@@ -795,6 +842,10 @@ std::ostream& operator<<(std::ostream& os, const FieldValue& value) {
   return os << value.ToString();
 }
 
+size_t FieldValueHash::operator()(const FieldValue& value) const {
+  return value.Hash();
+}
+
 ComparisonResult FieldValue::BaseValue::CompareTypes(
     const BaseValue& other) const {
   Type this_type = type();
@@ -224,6 +224,9 @@ class FieldValue {
   }
 
   util::ComparisonResult CompareTo(const FieldValue& rhs) const {
+    // Shared subtrees, such as the unchanged parts of a document that has been
+    // modified with ObjectValue::Set, compare the same without a deep walk.
+    if (rep_ == rhs.rep_) return util::ComparisonResult::Same;
     return rep_->CompareTo(*rhs.rep_);
   }
 
@@ -305,6 +308,19 @@ class ObjectValue : public util::Comparable<ObjectValue> {
    */
   absl::optional<FieldValue> Get(const FieldPath& field_path) const;
 
+  /**
+   * Returns a pointer to the value at the given path or nullptr if it doesn't
+   * exist. If the path is empty, a pointer to this object's FieldValue is
+   * returned.
+   *
+   * Unlike Get(), this does not copy the value. The pointer remains valid for
+   * as long as this ObjectValue (or any copy of it) is alive.
+   *
+   * @param field_path the path to search.
+   * @return The value at the path or nullptr if it doesn't exist.
+   */
+  const FieldValue* Find(const FieldPath& field_path) const;
+
   /**
    * Returns a FieldValue with the field at the named path set to value.
    * Any absent parent of the field will also be created accordingly.
@@ -431,6 +447,14 @@ inline bool operator>=(const FieldValue& lhs, const FieldValue& rhs) {
   return !(lhs < rhs);
 }
 
+/**
+ * Hashes FieldValues consistently with `operator==`, making it possible to use
+ * FieldValue as a key in unordered containers.
+ */
+struct FieldValueHash {
+  size_t operator()(const FieldValue& value) const;
+};
+
 // A bit pattern for our canonical NaN value. Exposed here for testing.
 ABSL_CONST_INIT extern const uint64_t kCanonicalNanBits;
 
@@ -98,6 +98,9 @@ using OptionalMaybeDocumentMap =
 using DocumentVersionMap =
     std::unordered_map<DocumentKey, SnapshotVersion, DocumentKeyHash>;
 
+using FieldMaskMap =
+    std::unordered_map<DocumentKey, FieldMask, DocumentKeyHash>;
+
 using DocumentUpdateMap = std::unordered_map<model::DocumentKey,
                                              model::MaybeDocument,
                                              model::DocumentKeyHash>;
@@ -38,6 +38,21 @@ MutationBatch::MutationBatch(int batch_id,
       base_mutations_(std::move(base_mutations)),
       mutations_(std::move(mutations)) {
   HARD_ASSERT(!mutations_.empty(), "Cannot create an empty mutation batch");
+
+  auto index = std::make_shared<MutationIndex>();
+  for (size_t i = 0; i < base_mutations_.size(); i++) {
+    (*index)[base_mutations_[i].key()].base_mutations.push_back(i);
+  }
+  for (size_t i = 0; i < mutations_.size(); i++) {
+    (*index)[mutations_[i].key()].mutations.push_back(i);
+  }
+  mutation_index_ = std::move(index);
+}
+
+const MutationBatch::MutationIndices* MutationBatch::FindMutations(
+    const DocumentKey& key) const {
+  auto found = mutation_index_->find(key);
+  return found != mutation_index_->end() ? &found->second : nullptr;
 }
 
 absl::optional<MaybeDocument> MutationBatch::ApplyToRemoteDocument(
@@ -53,12 +68,12 @@ absl::optional<MaybeDocument> MutationBatch::ApplyToRemoteDocument(
               "Mismatch between mutations length (%s) and results length (%s)",
               mutations_.size(), mutation_results.size());
 
-  for (size_t i = 0; i < mutations_.size(); i++) {
-    const Mutation& mutation = mutations_[i];
-    const MutationResult& mutation_result = mutation_results[i];
-    if (mutation.key() == document_key) {
-      maybe_doc = mutation.ApplyToRemoteDocument(maybe_doc, mutation_result);
-    }
+  const MutationIndices* indices = FindMutations(document_key);
+  if (!indices) return maybe_doc;
+
+  for (size_t i : indices->mutations) {
+    maybe_doc =
+        mutations_[i].ApplyToRemoteDocument(maybe_doc, mutation_results[i]);
   }
   return maybe_doc;
 }
@@ -70,34 +85,33 @@ absl::optional<MaybeDocument> MutationBatch::ApplyToLocalDocument(
               "key %s doesn't match maybe_doc key %s", document_key.ToString(),
               maybe_doc->key().ToString());
 
+  const MutationIndices* indices = FindMutations(document_key);
+  if (!indices) return maybe_doc;
+
   // First, apply the base state. This allows us to apply non-idempotent
   // transform against a consistent set of values.
-  for (const Mutation& mutation : base_mutations_) {
-    if (mutation.key() == document_key) {
-      maybe_doc = mutation.ApplyToLocalView(maybe_doc, local_write_time_);
-    }
+  for (size_t i : indices->base_mutations) {
+    maybe_doc =
+        base_mutations_[i].ApplyToLocalView(maybe_doc, local_write_time_);
   }
 
-  absl::optional<MaybeDocument> base_doc = maybe_doc;
-
   // Second, apply all user-provided mutations.
-  for (const Mutation& mutation : mutations_) {
-    if (mutation.key() == document_key) {
-      maybe_doc = mutation.ApplyToLocalView(maybe_doc, local_write_time_);
-    }
+  for (size_t i : indices->mutations) {
+    maybe_doc = mutations_[i].ApplyToLocalView(maybe_doc, local_write_time_);
   }
   return maybe_doc;
 }
 
 MaybeDocumentMap MutationBatch::ApplyToLocalDocumentSet(
     const MaybeDocumentMap& document_set) const {
-  // TODO(mrschmidt): This implementation is O(n^2). If we iterate through the
-  // mutations first (as done in `applyToLocalDocument:documentKey:`), we can
-  // reduce the complexity to O(n).
-
+  // Each document is visited once, and only its own mutations are applied to
+  // it, so this is linear in the number of mutations.
   MaybeDocumentMap mutated_documents = document_set;
-  for (const Mutation& mutation : mutations_) {
-    const DocumentKey& key = mutation.key();
+  for (const auto& entry : *mutation_index_) {
+    // Documents that only have base mutations aren't modified by the batch.
+    if (entry.second.mutations.empty()) continue;
+
+    const DocumentKey& key = entry.first;
 
     absl::optional<MaybeDocument> previous_document =
         mutated_documents.get(key);
@@ -20,9 +20,11 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Firestore/core/include/firebase/firestore/timestamp.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutation.h"
 #include "Firestore/core/src/model/types.h"
@@ -133,10 +135,33 @@ class MutationBatch {
   friend std::ostream& operator<<(std::ostream& os, const MutationBatch& batch);
 
  private:
+  /**
+   * The positions of the mutations of a single document in `base_mutations_`
+   * and `mutations_`, in order.
+   */
+  struct MutationIndices {
+    std::vector<size_t> base_mutations;
+    std::vector<size_t> mutations;
+  };
+
+  using MutationIndex =
+      std::unordered_map<DocumentKey, MutationIndices, DocumentKeyHash>;
+
+  /**
+   * Returns the positions of the mutations of the given document, or nullptr
+   * if this batch doesn't modify it.
+   */
+  const MutationIndices* FindMutations(const DocumentKey& key) const;
+
   int batch_id_;
   Timestamp local_write_time_;
   std::vector<Mutation> base_mutations_;
   std::vector<Mutation> mutations_;
+
+  // Built once on construction and shared between copies of the batch, so
+  // that applying the batch to a document only visits that document's
+  // mutations.
+  std::shared_ptr<const MutationIndex> mutation_index_;
 };
 
 inline bool operator!=(const MutationBatch& lhs, const MutationBatch& rhs) {
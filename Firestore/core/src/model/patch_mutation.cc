@@ -17,6 +17,7 @@
 #include "Firestore/core/src/model/patch_mutation.h"
 
 #include <cstdlib>
+#include <set>
 #include <utility>
 
 #include "Firestore/core/src/model/document.h"
@@ -62,6 +63,14 @@ PatchMutation::PatchMutation(DocumentKey key,
                                      std::vector<FieldTransform>())) {
 }
 
+FieldMask PatchMutation::WrittenFields() const {
+  std::set<FieldPath> fields(mask().begin(), mask().end());
+  for (const FieldTransform& transform : field_transforms()) {
+    fields.insert(transform.path());
+  }
+  return FieldMask(std::move(fields));
+}
+
 PatchMutation::Rep::Rep(DocumentKey&& key,
                         ObjectValue&& value,
                         FieldMask&& mask,
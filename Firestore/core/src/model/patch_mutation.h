@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_MODEL_PATCH_MUTATION_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -81,6 +82,12 @@ class PatchMutation : public Mutation {
     return patch_rep().mask();
   }
 
+  /**
+   * Returns all the fields this patch may change: the fields in mask() and
+   * the fields of its field transforms.
+   */
+  FieldMask WrittenFields() const;
+
  private:
   class Rep : public Mutation::Rep {
    public:
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/transaction.h"
 #include "Firestore/core/src/local/local_store.h"
@@ -51,6 +52,7 @@ using model::TargetId;
 using nanopb::ByteString;
 using util::AsyncQueue;
 using util::Status;
+using util::TimerId;
 
 /**
  * The maximum number of pending writes to allow.
@@ -67,7 +69,8 @@ RemoteStore::RemoteStore(
     : local_store_{local_store},
       datastore_{std::move(datastore)},
       online_state_tracker_{worker_queue, std::move(online_state_handler)},
-      connectivity_monitor_{NOT_NULL(connectivity_monitor)} {
+      connectivity_monitor_{NOT_NULL(connectivity_monitor)},
+      worker_queue_{worker_queue} {
   datastore_->Start();
 
   // Create streams (but note they're not started yet)
@@ -125,6 +128,10 @@ void RemoteStore::DisableNetwork() {
 }
 
 void RemoteStore::DisableNetworkInternal() {
+  // Acknowledged writes must be applied before the write pipeline is cleared,
+  // or refilling it would send them again.
+  ApplyPendingWriteResults();
+
   watch_stream_->Stop();
   write_stream_->Stop();
 
@@ -368,9 +375,7 @@ void RemoteStore::ProcessTargetError(const WatchTargetChange& change) {
 // Write Stream
 
 void RemoteStore::FillWritePipeline() {
-  BatchId last_batch_id_retrieved = write_pipeline_.empty()
-                                        ? kBatchIdUnknown
-                                        : write_pipeline_.back().batch_id();
+  BatchId last_batch_id_retrieved = LastBatchIdRetrieved();
   while (CanAddToWritePipeline()) {
     absl::optional<MutationBatch> batch =
         local_store_->GetNextMutationBatch(last_batch_id_retrieved);
@@ -389,6 +394,16 @@ void RemoteStore::FillWritePipeline() {
   }
 }
 
+BatchId RemoteStore::LastBatchIdRetrieved() const {
+  if (!write_pipeline_.empty()) {
+    return write_pipeline_.back().batch_id();
+  }
+  if (!pending_write_results_.empty()) {
+    return pending_write_results_.back().batch().batch_id();
+  }
+  return kBatchIdUnknown;
+}
+
 bool RemoteStore::CanAddToWritePipeline() const {
   return CanUseNetwork() && write_pipeline_.size() < kMaxPendingWrites;
 }
@@ -439,17 +454,40 @@ void RemoteStore::OnWriteStreamMutationResult(
   MutationBatch batch = write_pipeline_.front();
   write_pipeline_.erase(write_pipeline_.begin());
 
-  MutationBatchResult batch_result(std::move(batch), commit_version,
-                                   std::move(mutation_results),
-                                   write_stream_->last_stream_token());
-  sync_engine_->HandleSuccessfulWrite(batch_result);
+  pending_write_results_.emplace_back(std::move(batch), commit_version,
+                                      std::move(mutation_results),
+                                      write_stream_->last_stream_token());
+  if (!apply_write_results_) {
+    // Any acknowledgements that arrive before this runs are applied together
+    // with this one.
+    apply_write_results_ = worker_queue_->EnqueueAfterDelay(
+        AsyncQueue::Milliseconds(0), TimerId::ApplyWriteResults, [this] {
+          // Forget the handle, so that the operation doesn't cancel itself.
+          apply_write_results_ = {};
+          ApplyPendingWriteResults();
+        });
+  }
 
   // It's possible that with the completion of this mutation another slot has
   // freed up.
   FillWritePipeline();
 }
 
+void RemoteStore::ApplyPendingWriteResults() {
+  apply_write_results_.Cancel();
+  apply_write_results_ = {};
+  if (pending_write_results_.empty()) return;
+
+  std::vector<MutationBatchResult> batch_results;
+  std::swap(batch_results, pending_write_results_);
+  sync_engine_->HandleSuccessfulWrites(batch_results);
+}
+
 void RemoteStore::OnWriteStreamClose(const Status& status) {
+  // Writes acknowledged before the stream closed were sent before the write
+  // that may have failed, so apply them first.
+  ApplyPendingWriteResults();
+
   if (status.ok()) {
     // Graceful stop (due to Stop() or idle timeout). Make sure that's
     // desirable.
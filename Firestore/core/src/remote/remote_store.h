@@ -25,6 +25,7 @@
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/remote/datastore.h"
 #include "Firestore/core/src/remote/online_state_tracker.h"
@@ -74,12 +75,12 @@ class RemoteStoreCallback {
                                     util::Status error) = 0;
 
   /**
-   * Applies the result of a successful write of a mutation batch to the sync
-   * engine, emitting snapshots in any views that the mutation applies to, and
-   * removing the batch from the mutation queue.
+   * Applies the results of successful writes of consecutive mutation batches
+   * to the sync engine, emitting snapshots in any views that the mutations
+   * apply to, and removing the batches from the mutation queue.
    */
-  virtual void HandleSuccessfulWrite(
-      const model::MutationBatchResult& batch_result) = 0;
+  virtual void HandleSuccessfulWrites(
+      const std::vector<model::MutationBatchResult>& batch_results) = 0;
 
   /**
    * Rejects the batch, removing the batch from the mutation queue, recomputing
@@ -153,6 +154,17 @@ class RemoteStore : public TargetMetadataProvider,
    */
   void HandleCredentialChange();
 
+  /**
+   * Applies the write acknowledgements that have been received from the
+   * backend but not yet passed on to the sync engine.
+   *
+   * Acknowledgements are normally applied shortly after they are received, as
+   * a group. The sync engine has to call this before switching to another
+   * user, so that the acknowledgements are applied to the right mutation
+   * queue.
+   */
+  void ApplyPendingWriteResults();
+
   /**
    * Listens to the target identified by the given `TargetData`.
    *
@@ -229,6 +241,14 @@ class RemoteStore : public TargetMetadataProvider,
    */
   bool CanAddToWritePipeline() const;
 
+  /**
+   * Returns the ID of the last batch fetched from the `LocalStore` that is
+   * still in the mutation queue: the last batch in the write pipeline or, if
+   * the pipeline is empty, the last acknowledged batch that is yet to be
+   * applied.
+   */
+  model::BatchId LastBatchIdRetrieved() const;
+
   void StartWriteStream();
 
   /**
@@ -304,6 +324,21 @@ class RemoteStore : public TargetMetadataProvider,
    * the `write_pipeline_` as we receive responses.
    */
   std::vector<model::MutationBatch> write_pipeline_;
+
+  std::shared_ptr<util::AsyncQueue> worker_queue_;
+
+  /**
+   * Results of writes that have been acknowledged by the backend but not yet
+   * applied by the sync engine.
+   *
+   * Rather than applying each acknowledgement in its own transaction, the
+   * `RemoteStore` schedules `apply_write_results_` on receiving the first one,
+   * and applies all those received by the time it runs as one group. This
+   * way, acknowledgements that arrive while the previous group is being
+   * applied share a single transaction and a single view update.
+   */
+  std::vector<model::MutationBatchResult> pending_write_results_;
+  util::DelayedOperation apply_write_results_;
 };
 
 }  // namespace remote
@@ -66,7 +66,13 @@ enum class TimerId {
    * A timer used to retry transactions. Since there can be multiple concurrent
    * transactions, multiple of these may be in the queue at a given time.
    */
-  RetryTransaction
+  RetryTransaction,
+
+  /**
+   * A timer used in `RemoteStore` to apply the write acknowledgements received
+   * since it was scheduled as a single group.
+   */
+  ApplyWriteResults
 };
 
 // A serial queue that executes given operations asynchronously, one at a time.
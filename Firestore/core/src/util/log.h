@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_UTIL_LOG_H_
 #define FIRESTORE_CORE_SRC_UTIL_LOG_H_
 
+#include <cstddef>
 #include <string>
 
 #include "Firestore/core/src/util/string_format.h"
@@ -37,20 +38,23 @@ enum LogLevel {
   kLogLevelError,
 };
 
+// The lowest level at which log statements are compiled in. Statements below
+// it are removed at compile time, along with the formatting of their
+// arguments, and can't be turned back on with `LogSetLevel`. Builds that never
+// need debug logs can define this, e.g. as `kLogLevelWarning`.
+#ifndef FIRESTORE_LOG_MIN_LEVEL
+#define FIRESTORE_LOG_MIN_LEVEL kLogLevelDebug
+#endif
+
+constexpr LogLevel kLogMinLevel = FIRESTORE_LOG_MIN_LEVEL;
+
 // Log a message if kLogLevelDebug is enabled. Arguments are not evaluated if
 // logging is disabled.
 //
 // @param format A format string suitable for use with `util::StringFormat`
 // @param ... C++ variadic arguments that match the format string. Not C
 //     varargs.
-#define LOG_DEBUG(...)                                         \
-  do {                                                         \
-    namespace _util = firebase::firestore::util;               \
-    if (_util::LogIsLoggable(_util::kLogLevelDebug)) {         \
-      std::string _message = _util::StringFormat(__VA_ARGS__); \
-      _util::LogMessage(_util::kLogLevelDebug, _message);      \
-    }                                                          \
-  } while (0)
+#define LOG_DEBUG(...) FIRESTORE_LOG_INTERNAL(kLogLevelDebug, __VA_ARGS__)
 
 // Log a message if kLogLevelWarn is enabled (it is by default). Arguments are
 // not evaluated if logging is disabled.
@@ -58,14 +62,7 @@ enum LogLevel {
 // @param format A format string suitable for use with `util::StringFormat`
 // @param ... C++ variadic arguments that match the format string. Not C
 //     varargs.
-#define LOG_WARN(...)                                          \
-  do {                                                         \
-    namespace _util = firebase::firestore::util;               \
-    if (_util::LogIsLoggable(_util::kLogLevelWarning)) {       \
-      std::string _message = _util::StringFormat(__VA_ARGS__); \
-      _util::LogMessage(_util::kLogLevelWarning, _message);    \
-    }                                                          \
-  } while (0)
+#define LOG_WARN(...) FIRESTORE_LOG_INTERNAL(kLogLevelWarning, __VA_ARGS__)
 
 // Log a message if kLogLevelError is enabled (it is by default). Arguments are
 // not evaluated if logging is disabled.
@@ -73,13 +70,17 @@ enum LogLevel {
 // @param format A format string suitable for use with `util::StringFormat`
 // @param ... C++ variadic arguments that match the format string. Not C
 //     varargs.
-#define LOG_ERROR(...)                                         \
-  do {                                                         \
-    namespace _util = firebase::firestore::util;               \
-    if (_util::LogIsLoggable(_util::kLogLevelError)) {         \
-      std::string _message = _util::StringFormat(__VA_ARGS__); \
-      _util::LogMessage(_util::kLogLevelError, _message);      \
-    }                                                          \
+#define LOG_ERROR(...) FIRESTORE_LOG_INTERNAL(kLogLevelError, __VA_ARGS__)
+
+// Formats into the calling thread's log buffer, so that enabled log
+// statements reuse its memory instead of building a new string each time.
+#define FIRESTORE_LOG_INTERNAL(level, ...)                             \
+  do {                                                                 \
+    namespace _util = firebase::firestore::util;                       \
+    if (_util::level >= _util::kLogMinLevel &&                         \
+        _util::LogIsLoggable(_util::level)) {                          \
+      _util::internal::LogFormattedMessage(_util::level, __VA_ARGS__); \
+    }                                                                  \
   } while (0)
 
 // Tests to see if the given log level is loggable.
@@ -87,7 +88,7 @@ bool LogIsLoggable(LogLevel level);
 
 // Is debug logging enabled?
 inline bool LogIsDebugEnabled() {
-  return LogIsLoggable(kLogLevelDebug);
+  return kLogLevelDebug >= kLogMinLevel && LogIsLoggable(kLogLevelDebug);
 }
 
 // All messages at or above the specified log level value are displayed.
@@ -96,6 +97,43 @@ void LogSetLevel(LogLevel level);
 // Log a message at the given level.
 void LogMessage(LogLevel log_level, const std::string& message);
 
+namespace internal {
+
+// The most memory a thread's log buffer keeps between messages. Longer
+// messages are still logged in full, but their memory is released afterwards.
+constexpr size_t kLogBufferMaxCapacity = 4 * 1024;
+
+// Returns the calling thread's log buffer.
+inline std::string& LogBuffer() {
+  static thread_local std::string buffer;
+  return buffer;
+}
+
+// Formats a message into the log buffer. The buffer is only claimed once all
+// the arguments have been evaluated, so arguments may log themselves.
+template <typename... FA>
+const std::string& LogFormat(const char* format, const FA&... args) {
+  std::string& buffer = LogBuffer();
+  buffer.clear();
+  StringFormatTo(&buffer, format, args...);
+  return buffer;
+}
+
+// Formats a message into the log buffer and logs it at the given level.
+template <typename... FA>
+void LogFormattedMessage(LogLevel log_level,
+                         const char* format,
+                         const FA&... args) {
+  LogMessage(log_level, LogFormat(format, args...));
+
+  std::string& buffer = LogBuffer();
+  if (buffer.capacity() > kLogBufferMaxCapacity) {
+    std::string().swap(buffer);
+  }
+}
+
+}  // namespace internal
+
 }  // namespace util
 }  // namespace firestore
 }  // namespace firebase
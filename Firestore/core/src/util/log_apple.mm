@@ -84,6 +84,9 @@ bool LogIsLoggable(LogLevel level) {
   return FIRIsLoggableLevel(ToFIRLoggerLevel(level), false);
 }
 
+// FIRLogger formats every message into an NSString of its own, so messages
+// logged on Apple platforms always allocate, even though the C++ side formats
+// them into a reused buffer.
 void LogMessage(LogLevel level, const std::string& message) {
   LogMessageV(level, @"%s", message.c_str());
 }
@@ -27,6 +27,14 @@ static const char* kInvalid = "<invalid>";
 std::string StringFormatPieces(
     const char* format, std::initializer_list<absl::string_view> pieces) {
   std::string result;
+  StringFormatPiecesTo(&result, format, pieces);
+  return result;
+}
+
+void StringFormatPiecesTo(std::string* dest,
+                          const char* format,
+                          std::initializer_list<absl::string_view> pieces) {
+  std::string& result = *dest;
 
   const char* format_iter = format;
   const char* format_end = format + strlen(format);
@@ -84,8 +92,6 @@ std::string StringFormatPieces(
 
     format_iter = spec_ptr + 1;
   }
-
-  return result;
 }
 
 }  // namespace internal
@@ -37,6 +37,10 @@ namespace internal {
 std::string StringFormatPieces(const char* format,
                                std::initializer_list<absl::string_view> pieces);
 
+void StringFormatPiecesTo(std::string* dest,
+                          const char* format,
+                          std::initializer_list<absl::string_view> pieces);
+
 /**
  * Explicit ranking for formatting choices. Only useful as an implementation
  * detail of `FormatArg`.
@@ -165,6 +169,17 @@ inline std::string StringFormat() {
   return {};
 }
 
+/**
+ * Formats a string like `StringFormat`, but appends the result to `dest`
+ * instead of returning a new string. Reusing a destination whose capacity is
+ * already large enough formats without allocating.
+ */
+template <typename... FA>
+void StringFormatTo(std::string* dest, const char* format, const FA&... args) {
+  internal::StringFormatPiecesTo(
+      dest, format, {static_cast<const FormatArg&>(args).Piece()...});
+}
+
 }  // namespace util
 }  // namespace firestore
 }  // namespace firebase
@@ -17,11 +17,14 @@
 #include "Firestore/core/src/core/query.h"
 
 #include <cmath>
+#include <string>
+#include <vector>
 
 #include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_mask.h"
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/field_value.h"
 #include "Firestore/core/src/model/resource_path.h"
@@ -36,6 +39,7 @@ namespace core {
 using firebase::firestore::util::ComparisonResult;
 using model::Document;
 using model::DocumentComparator;
+using model::FieldMask;
 using model::FieldPath;
 using model::FieldValue;
 using model::ResourcePath;
@@ -264,6 +268,28 @@ TEST(QueryTest, InFilters) {
   // Nested match.
   doc = Doc("collection/1", 0, Map("zip", Array("12345", Map("zip", 12345))));
   EXPECT_THAT(query, Not(Matches(doc)));
+
+  // Numeric type mismatch.
+  doc = Doc("collection/1", 0, Map("zip", 12345.0));
+  EXPECT_THAT(query, Not(Matches(doc)));
+}
+
+TEST(QueryTest, InFiltersWithManyValues) {
+  std::vector<FieldValue> values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(Value(i));
+    values.push_back(Value(std::to_string(i)));
+  }
+  auto query =
+      testutil::Query("collection")
+          .AddingFilter(Filter("zip", "in", FieldValue::FromArray(values)));
+
+  EXPECT_THAT(query, Matches(Doc("collection/1", 0, Map("zip", 0))));
+  EXPECT_THAT(query, Matches(Doc("collection/1", 0, Map("zip", 9))));
+  EXPECT_THAT(query, Matches(Doc("collection/1", 0, Map("zip", "5"))));
+  EXPECT_THAT(query, Not(Matches(Doc("collection/1", 0, Map("zip", 10)))));
+  EXPECT_THAT(query, Not(Matches(Doc("collection/1", 0, Map("zip", 5.0)))));
+  EXPECT_THAT(query, Not(Matches(Doc("collection/1", 0, Map("zip", "10")))));
 }
 
 TEST(QueryTest, InFiltersWithObjectValues) {
@@ -816,6 +842,26 @@ TEST(QueryTest, MatchesAllDocuments) {
   EXPECT_FALSE(query.MatchesAllDocuments());
 }
 
+TEST(QueryTest, MayBeAffectedByFieldsItFiltersOrOrdersBy) {
+  auto query = testutil::Query("coll")
+                   .AddingFilter(Filter("a.b", "==", 1))
+                   .AddingOrderBy(OrderBy("c"));
+
+  EXPECT_TRUE(query.MayBeAffectedBy(FieldMask{Field("a.b")}));
+  EXPECT_TRUE(query.MayBeAffectedBy(FieldMask{Field("a")}));
+  EXPECT_TRUE(query.MayBeAffectedBy(FieldMask{Field("a.b.c")}));
+  EXPECT_TRUE(query.MayBeAffectedBy(FieldMask{Field("d"), Field("c")}));
+
+  EXPECT_FALSE(query.MayBeAffectedBy(FieldMask{}));
+  EXPECT_FALSE(query.MayBeAffectedBy(FieldMask{Field("a.c")}));
+  EXPECT_FALSE(query.MayBeAffectedBy(FieldMask{Field("d"), Field("e.c")}));
+
+  // The implicit order by the inequality field counts too.
+  query = testutil::Query("coll").AddingFilter(Filter("f", ">", 1));
+  EXPECT_TRUE(query.MayBeAffectedBy(FieldMask{Field("f")}));
+  EXPECT_FALSE(query.MayBeAffectedBy(FieldMask{Field("g")}));
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
@@ -0,0 +1,506 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the cost of delivering changes to many active queries.
+//
+// The SyncEngine benchmarks wire a real SyncEngine, LocalStore and
+// EventManager to a RemoteStore whose network is never enabled, so listens
+// and writes never leave the process. Remote events and write
+// acknowledgements are injected directly, the way the RemoteStore would
+// deliver them. As in the client, these components are only used on the
+// worker queue, so the benchmark loops run there too. The View and
+// EventManager benchmarks measure those stages of the pipeline in isolation.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/auth/empty_credentials_provider.h"
+#include "Firestore/core/src/auth/user.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/event_manager.h"
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/core/query_listener.h"
+#include "Firestore/core/src/core/sync_engine.h"
+#include "Firestore/core/src/core/view.h"
+#include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/document_map.h"
+#include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_value.h"
+#include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/remote_event.h"
+#include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/remote/watch_change.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/fake_target_metadata_provider.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_format.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using auth::EmptyCredentialsProvider;
+using auth::User;
+using local::LocalStore;
+using local::Persistence;
+using local::QueryEngine;
+using local::QueryPurpose;
+using local::TargetData;
+using model::DatabaseId;
+using model::Document;
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::DocumentSet;
+using model::FieldValue;
+using model::MaybeDocumentMap;
+using model::Mutation;
+using model::MutationBatch;
+using model::MutationBatchResult;
+using model::MutationResult;
+using model::OnlineState;
+using model::SnapshotVersion;
+using model::TargetId;
+using remote::ConnectivityMonitor;
+using remote::Datastore;
+using remote::DocumentWatchChange;
+using remote::FakeTargetMetadataProvider;
+using remote::FirebaseMetadataProvider;
+using remote::RemoteEvent;
+using remote::RemoteStore;
+using remote::WatchChangeAggregator;
+using remote::WatchTargetChange;
+using remote::WatchTargetChangeState;
+using testutil::Doc;
+using testutil::Key;
+using testutil::Map;
+using testutil::Version;
+using util::AsyncQueue;
+using util::Status;
+using util::StatusOr;
+
+// The number of documents in the listened collection.
+const int64_t kDocumentCount = 1000;
+
+const size_t kMaxConcurrentLimboResolutions = 100;
+
+std::string DocumentPath(int64_t index) {
+  return absl::StrFormat("coll/doc%08d", index);
+}
+
+Document MakeDocument(int64_t index, int64_t version) {
+  return Doc(DocumentPath(index), version,
+             Map("index", index, "version", version, "text",
+                 std::string(100, 'x')));
+}
+
+/**
+ * Returns the `i`th of a family of distinct queries over the same
+ * collection, all of which match every document.
+ */
+Query MatchingQuery(int64_t i) {
+  return testutil::Query("coll").AddingFilter(
+      testutil::Filter("index", ">=", FieldValue::FromInteger(-i)));
+}
+
+/** Returns the indexes of `count` documents spread across the collection. */
+std::vector<int64_t> SpreadIndexes(int64_t count) {
+  std::vector<int64_t> indexes;
+  for (int64_t i = 0; i < count; ++i) {
+    indexes.push_back(i * kDocumentCount / count);
+  }
+  return indexes;
+}
+
+/**
+ * A SyncEngine listening to `query_count` distinct queries over a collection
+ * of `kDocumentCount` documents, each of which matches all of them.
+ */
+class SyncEngineHarness {
+ public:
+  explicit SyncEngineHarness(int64_t query_count)
+      : worker_queue_(testutil::AsyncQueueForTesting()),
+        persistence_(local::MemoryPersistenceWithEagerGcForTesting()),
+        local_store_(persistence_.get(), &query_engine_,
+                     User::Unauthenticated()),
+        database_info_(DatabaseId("p", "d"), "", "localhost", false),
+        connectivity_monitor_(remote::CreateNoOpConnectivityMonitor()),
+        firebase_metadata_provider_(
+            remote::CreateFirebaseMetadataProviderNoOp()),
+        datastore_(std::make_shared<Datastore>(
+            database_info_, worker_queue_,
+            std::make_shared<EmptyCredentialsProvider>(),
+            connectivity_monitor_.get(), firebase_metadata_provider_.get())),
+        remote_store_(&local_store_, datastore_, worker_queue_,
+                      connectivity_monitor_.get(), [](OnlineState) {}),
+        sync_engine_(&local_store_, &remote_store_, User::Unauthenticated(),
+                     kMaxConcurrentLimboResolutions),
+        event_manager_(&sync_engine_) {
+    RunOnWorkerQueue([&] {
+      local_store_.Start();
+      remote_store_.set_sync_engine(&sync_engine_);
+
+      for (int64_t i = 0; i < query_count; ++i) {
+        Query query = MatchingQuery(i);
+        auto listener = QueryListener::Create(
+            query, [this](const StatusOr<ViewSnapshot>&) { ++snapshots_; });
+        target_ids_.push_back(event_manager_.AddQueryListener(listener));
+        queries_.push_back(std::move(query));
+        listeners_.push_back(std::move(listener));
+      }
+
+      std::vector<int64_t> indexes;
+      for (int64_t i = 0; i < kDocumentCount; ++i) {
+        indexes.push_back(i);
+      }
+      sync_engine_.ApplyRemoteEvent(MakeUpdateEvent(indexes));
+    });
+  }
+
+  ~SyncEngineHarness() {
+    RunOnWorkerQueue([&] {
+      for (const auto& listener : listeners_) {
+        event_manager_.RemoveQueryListener(listener);
+      }
+      remote_store_.Shutdown();
+    });
+    persistence_->Shutdown();
+  }
+
+  /** Runs the given operation on the worker queue and waits for it. */
+  template <typename F>
+  void RunOnWorkerQueue(F&& operation) {
+    worker_queue_->EnqueueBlocking(std::forward<F>(operation));
+  }
+
+  SyncEngine* sync_engine() {
+    return &sync_engine_;
+  }
+
+  int64_t snapshots() const {
+    return snapshots_;
+  }
+
+  /**
+   * Returns a remote event that updates the documents with the given indexes
+   * in every query, and marks every query's target current.
+   */
+  RemoteEvent MakeUpdateEvent(const std::vector<int64_t>& indexes) {
+    int64_t version = NextVersion();
+    WatchChangeAggregator aggregator = MakeAggregator();
+    for (int64_t index : indexes) {
+      Document doc = MakeDocument(index, version);
+      aggregator.HandleDocumentChange(
+          DocumentWatchChange{target_ids_, {}, doc.key(), doc});
+      synced_keys_ = synced_keys_.insert(doc.key());
+    }
+    return FinishEvent(&aggregator, version);
+  }
+
+  /**
+   * Returns a remote event that removes the documents with the given indexes
+   * from every query's results without deleting them, which puts them in
+   * limbo.
+   */
+  RemoteEvent MakeRemovalEvent(const std::vector<int64_t>& indexes) {
+    int64_t version = NextVersion();
+    WatchChangeAggregator aggregator = MakeAggregator();
+    for (int64_t index : indexes) {
+      DocumentKey key = Key(DocumentPath(index));
+      aggregator.HandleDocumentChange(
+          DocumentWatchChange{{}, target_ids_, key, absl::nullopt});
+      synced_keys_ = synced_keys_.erase(key);
+    }
+    return FinishEvent(&aggregator, version);
+  }
+
+  /** Writes a single batch patching the documents with the given indexes. */
+  void WriteMutations(const std::vector<int64_t>& indexes) {
+    int64_t version = NextVersion();
+    std::vector<Mutation> mutations;
+    for (int64_t index : indexes) {
+      mutations.push_back(testutil::PatchMutation(DocumentPath(index),
+                                                  Map("version", version)));
+    }
+    sync_engine_.WriteMutations(std::move(mutations), [](const Status&) {});
+  }
+
+  /** Acknowledges the oldest pending write. */
+  void AcknowledgeWrite() {
+    absl::optional<MutationBatch> batch =
+        local_store_.GetNextMutationBatch(model::kBatchIdUnknown);
+    SnapshotVersion version = Version(NextVersion());
+    std::vector<MutationResult> results(
+        batch->mutations().size(), MutationResult(version, absl::nullopt));
+    sync_engine_.HandleSuccessfulWrites(
+        {MutationBatchResult(*batch, version, std::move(results), {})});
+  }
+
+ private:
+  int64_t NextVersion() {
+    return ++version_;
+  }
+
+  WatchChangeAggregator MakeAggregator() {
+    metadata_provider_ = FakeTargetMetadataProvider{};
+    for (size_t i = 0; i < queries_.size(); ++i) {
+      metadata_provider_.SetSyncedKeys(
+          synced_keys_, TargetData(queries_[i].ToTarget(), target_ids_[i], 0,
+                                   QueryPurpose::Listen));
+    }
+    return WatchChangeAggregator{&metadata_provider_};
+  }
+
+  RemoteEvent FinishEvent(WatchChangeAggregator* aggregator, int64_t version) {
+    aggregator->HandleTargetChange(
+        WatchTargetChange{WatchTargetChangeState::Current, target_ids_,
+                          testutil::ResumeToken(version)});
+    return aggregator->CreateRemoteEvent(Version(version));
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::unique_ptr<Persistence> persistence_;
+  QueryEngine query_engine_;
+  LocalStore local_store_;
+
+  DatabaseInfo database_info_;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider_;
+  std::shared_ptr<Datastore> datastore_;
+  RemoteStore remote_store_;
+
+  SyncEngine sync_engine_;
+  EventManager event_manager_;
+
+  std::vector<Query> queries_;
+  std::vector<TargetId> target_ids_;
+  std::vector<std::shared_ptr<QueryListener>> listeners_;
+  int64_t snapshots_ = 0;
+
+  FakeTargetMetadataProvider metadata_provider_;
+  DocumentKeySet synced_keys_;
+  int64_t version_ = 0;
+};
+
+// Number of active queries, and number of documents changed at once.
+void FanOutArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"queries", "changes"});
+  for (int64_t queries : {1, 10, 100}) {
+    for (int64_t changes : {1, 10, 100}) {
+      benchmark->Args({queries, changes});
+    }
+  }
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+// Applies a remote event through the whole pipeline: the LocalStore, every
+// query's View, and the EventManager dispatching the resulting snapshots.
+void BM_SyncEngineApplyRemoteEvent(benchmark::State& state) {
+  SyncEngineHarness harness(state.range(0));
+  std::vector<int64_t> indexes = SpreadIndexes(state.range(1));
+
+  harness.RunOnWorkerQueue([&] {
+    for (auto _ : state) {
+      state.PauseTiming();
+      RemoteEvent event = harness.MakeUpdateEvent(indexes);
+      state.ResumeTiming();
+
+      harness.sync_engine()->ApplyRemoteEvent(event);
+    }
+  });
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+  state.counters["snapshots"] = benchmark::Counter(
+      harness.snapshots(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SyncEngineApplyRemoteEvent)->Apply(FanOutArguments);
+
+// Writes a batch locally, which raises latency-compensated snapshots in every
+// query. The acknowledgement of the batch is not measured.
+void BM_SyncEngineWriteMutations(benchmark::State& state) {
+  SyncEngineHarness harness(state.range(0));
+  std::vector<int64_t> indexes = SpreadIndexes(state.range(1));
+
+  harness.RunOnWorkerQueue([&] {
+    for (auto _ : state) {
+      harness.WriteMutations(indexes);
+
+      state.PauseTiming();
+      harness.AcknowledgeWrite();
+      state.ResumeTiming();
+    }
+  });
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(BM_SyncEngineWriteMutations)->Apply(FanOutArguments);
+
+// Alternately removes documents from every query's results, putting them in
+// limbo, and adds them back, resolving the limbo.
+void BM_SyncEngineLimboTracking(benchmark::State& state) {
+  SyncEngineHarness harness(state.range(0));
+  std::vector<int64_t> indexes = SpreadIndexes(state.range(1));
+
+  bool remove = true;
+  harness.RunOnWorkerQueue([&] {
+    for (auto _ : state) {
+      state.PauseTiming();
+      RemoteEvent event = remove ? harness.MakeRemovalEvent(indexes)
+                                 : harness.MakeUpdateEvent(indexes);
+      remove = !remove;
+      state.ResumeTiming();
+
+      harness.sync_engine()->ApplyRemoteEvent(event);
+    }
+  });
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_SyncEngineLimboTracking)->Apply(FanOutArguments);
+
+// Computes the changes to a single view of the collection, without the rest
+// of the pipeline.
+void BM_ViewComputeDocumentChanges(benchmark::State& state, bool limit) {
+  Query query = testutil::Query("coll");
+  if (limit) {
+    query = query.AddingOrderBy(testutil::OrderBy("index"))
+                .WithLimitToFirst(kDocumentCount / 2);
+  }
+
+  View view(query, DocumentKeySet{});
+  MaybeDocumentMap documents;
+  for (int64_t i = 0; i < kDocumentCount; ++i) {
+    Document doc = MakeDocument(i, 1);
+    documents = documents.insert(doc.key(), doc);
+  }
+  view.ApplyChanges(view.ComputeDocumentChanges(documents));
+
+  MaybeDocumentMap changes;
+  for (int64_t index : SpreadIndexes(state.range(0))) {
+    Document doc = MakeDocument(index, 2);
+    changes = changes.insert(doc.key(), doc);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(view.ComputeDocumentChanges(changes));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_ViewComputeDocumentChanges, Unlimited, false)
+    ->ArgName("changes")
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ViewComputeDocumentChanges, Limit, true)
+    ->ArgName("changes")
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+
+/** A QueryEventSource that assigns target IDs and does nothing else. */
+class FakeQueryEventSource : public QueryEventSource {
+ public:
+  void SetCallback(SyncEngineCallback*) override {
+  }
+
+  TargetId Listen(Query) override {
+    return next_target_id_++;
+  }
+
+  void StopListening(const Query&) override {
+  }
+
+ private:
+  TargetId next_target_id_ = 1;
+};
+
+// Dispatches a snapshot of each query, each with the given number of changed
+// documents, to that query's listener.
+void BM_EventManagerOnViewSnapshots(benchmark::State& state) {
+  FakeQueryEventSource event_source;
+  EventManager event_manager(&event_source);
+  int64_t events = 0;
+
+  std::vector<Query> queries;
+  std::vector<std::shared_ptr<QueryListener>> listeners;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    queries.push_back(MatchingQuery(i));
+    listeners.push_back(QueryListener::Create(
+        queries.back(), [&](const StatusOr<ViewSnapshot>&) { ++events; }));
+    event_manager.AddQueryListener(listeners.back());
+  }
+
+  std::vector<int64_t> indexes = SpreadIndexes(state.range(1));
+  int64_t version = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ++version;
+    std::vector<ViewSnapshot> snapshots;
+    for (const Query& query : queries) {
+      DocumentSet old_documents{query.Comparator()};
+      DocumentSet documents{query.Comparator()};
+      std::vector<DocumentViewChange> changes;
+      for (int64_t index : indexes) {
+        old_documents = old_documents.insert(MakeDocument(index, version));
+        Document doc = MakeDocument(index, version + 1);
+        documents = documents.insert(doc);
+        changes.emplace_back(doc, DocumentViewChange::Type::Modified);
+      }
+      snapshots.emplace_back(query, documents, old_documents,
+                             std::move(changes), DocumentKeySet{},
+                             /* from_cache= */ false,
+                             /* sync_state_changed= */ true,
+                             /* excludes_metadata_changes= */ false);
+    }
+    state.ResumeTiming();
+
+    event_manager.OnViewSnapshots(std::move(snapshots));
+  }
+  state.SetItemsProcessed(events);
+
+  for (const auto& listener : listeners) {
+    event_manager.RemoveQueryListener(listener);
+  }
+}
+BENCHMARK(BM_EventManagerOnViewSnapshots)->Apply(FanOutArguments);
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/sync_engine.h"
+
+#include <memory>
+#include <vector>
+
+#include "Firestore/core/src/auth/empty_credentials_provider.h"
+#include "Firestore/core/src/auth/user.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/core/sync_engine_callback.h"
+#include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/fake_datastore.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using auth::EmptyCredentialsProvider;
+using auth::User;
+using local::LocalStore;
+using local::Persistence;
+using local::QueryEngine;
+using model::DatabaseId;
+using model::kBatchIdUnknown;
+using model::OnlineState;
+using remote::ConnectivityMonitor;
+using remote::FakeDatastore;
+using remote::FirebaseMetadataProvider;
+using remote::RemoteStore;
+using testutil::Map;
+using testutil::SetMutation;
+using util::AsyncQueue;
+using util::Status;
+using util::TimerId;
+
+const size_t kMaxConcurrentLimboResolutions = 100;
+
+/**
+ * Wires a `SyncEngine` to a real `LocalStore` and `RemoteStore`, with a
+ * `FakeDatastore` standing in for the backend.
+ */
+class SyncEngineTest : public testing::Test, public SyncEngineCallback {
+ public:
+  SyncEngineTest()
+      : worker_queue_(testutil::AsyncQueueForTesting()),
+        persistence_(local::MemoryPersistenceWithEagerGcForTesting()),
+        local_store_(persistence_.get(), &query_engine_,
+                     User::Unauthenticated()),
+        database_info_(DatabaseId("p", "d"), "", "localhost", false),
+        connectivity_monitor_(remote::CreateNoOpConnectivityMonitor()),
+        firebase_metadata_provider_(
+            remote::CreateFirebaseMetadataProviderNoOp()),
+        datastore_(std::make_shared<FakeDatastore>(
+            database_info_, worker_queue_,
+            std::make_shared<EmptyCredentialsProvider>(),
+            connectivity_monitor_.get(), firebase_metadata_provider_.get())),
+        remote_store_(&local_store_, datastore_, worker_queue_,
+                      connectivity_monitor_.get(), [](OnlineState) {}),
+        sync_engine_(&local_store_, &remote_store_, User::Unauthenticated(),
+                     kMaxConcurrentLimboResolutions) {
+    worker_queue_->EnqueueBlocking([&] {
+      local_store_.Start();
+      remote_store_.set_sync_engine(&sync_engine_);
+      sync_engine_.SetCallback(this);
+      remote_store_.EnableNetwork();
+    });
+  }
+
+  ~SyncEngineTest() override {
+    worker_queue_->EnqueueBlocking([&] { remote_store_.Shutdown(); });
+  }
+
+  // Implements `SyncEngineCallback`.
+  void HandleOnlineStateChange(OnlineState) override {
+  }
+  void OnViewSnapshots(std::vector<ViewSnapshot>&&) override {
+  }
+  void OnError(const Query&, const Status&) override {
+  }
+
+ protected:
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::unique_ptr<Persistence> persistence_;
+  QueryEngine query_engine_;
+  LocalStore local_store_;
+  DatabaseInfo database_info_;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider_;
+  std::shared_ptr<FakeDatastore> datastore_;
+  RemoteStore remote_store_;
+  SyncEngine sync_engine_;
+};
+
+TEST_F(SyncEngineTest, CompletesAcknowledgedWritesOfThePreviousUser) {
+  absl::optional<Status> write_status;
+  worker_queue_->EnqueueBlocking([&] {
+    sync_engine_.WriteMutations({SetMutation("coll/a", Map("a", 1))},
+                                [&](Status status) { write_status = status; });
+  });
+  EXPECT_EQ(datastore_->WritesSent(), 1);
+
+  // The user changes after the acknowledgement is received, but before the
+  // remote store applies it.
+  worker_queue_->EnqueueBlocking([&] {
+    datastore_->AckWrite(testutil::Version(1), {testutil::MutationResult(1)});
+  });
+  ASSERT_TRUE(worker_queue_->IsScheduled(TimerId::ApplyWriteResults));
+  worker_queue_->EnqueueBlocking(
+      [&] { sync_engine_.HandleCredentialChange(User("other")); });
+
+  EXPECT_FALSE(worker_queue_->IsScheduled(TimerId::ApplyWriteResults));
+  ASSERT_TRUE(write_status.has_value());
+  EXPECT_TRUE(write_status->ok());
+
+  // The acknowledged batch was removed from the previous user's queue, so it
+  // is not sent again once they are back.
+  worker_queue_->EnqueueBlocking([&] {
+    sync_engine_.HandleCredentialChange(User::Unauthenticated());
+    EXPECT_EQ(local_store_.GetNextMutationBatch(kBatchIdUnknown),
+              absl::nullopt);
+  });
+  EXPECT_EQ(datastore_->WritesSent(), 0);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
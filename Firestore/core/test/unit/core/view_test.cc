@@ -25,6 +25,7 @@
 #include "Firestore/core/src/core/view_snapshot.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_mask.h"
 #include "Firestore/core/src/model/no_document.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
@@ -41,6 +42,8 @@ using model::Document;
 using model::DocumentKeySet;
 using model::DocumentSet;
 using model::DocumentState;
+using model::FieldMask;
+using model::FieldMaskMap;
 using model::FieldValue;
 using model::ResourcePath;
 
@@ -677,6 +680,53 @@ TEST(ViewTest, SuppressesWriteAcknowledgementIfWatchHasNotCaughtUp) {
                                      DocumentViewChange::Type::Metadata}));
 }
 
+TEST(ViewTest, DoesNotReevaluateDocumentsPatchedOnlyInIgnoredFields) {
+  Query query = QueryForMessages()
+                    .AddingFilter(Filter("sort", "<=", 2))
+                    .AddingOrderBy(OrderBy("sort"))
+                    .WithLimitToFirst(2);
+  Document doc1 = Doc("rooms/eros/messages/1", 0, Map("sort", 1));
+  Document doc2 = Doc("rooms/eros/messages/2", 0, Map("sort", 2));
+  View view(query, DocumentKeySet{});
+  ApplyChanges(&view, {doc1, doc2}, absl::nullopt);
+
+  // The changed fields say that only "text" changed, so the view trusts that
+  // the document still matches and keeps its place, even though the new data
+  // would put it outside the query.
+  Document doc1_patched =
+      Doc("rooms/eros/messages/1", 0, Map("sort", 3, "text", "msg1"),
+          DocumentState::kLocalMutations);
+  FieldMaskMap changed_fields{{doc1.key(), FieldMask{Field("text")}}};
+  ViewDocumentChanges changes = view.ComputeDocumentChanges(
+      DocUpdates({doc1_patched}), absl::nullopt, changed_fields);
+
+  EXPECT_FALSE(changes.needs_refill());
+  EXPECT_THAT(changes.document_set(), ContainsDocs({doc1_patched, doc2}));
+}
+
+TEST(ViewTest, ReevaluatesDocumentsPatchedInQueryFields) {
+  Query query = QueryForMessages()
+                    .AddingFilter(Filter("sort", "<=", 2))
+                    .AddingOrderBy(OrderBy("sort"))
+                    .WithLimitToFirst(2);
+  Document doc1 = Doc("rooms/eros/messages/1", 0, Map("sort", 1));
+  Document doc2 = Doc("rooms/eros/messages/2", 0, Map("sort", 2));
+  View view(query, DocumentKeySet{});
+  ApplyChanges(&view, {doc1, doc2}, absl::nullopt);
+
+  Document doc1_patched = Doc("rooms/eros/messages/1", 0, Map("sort", 3),
+                              DocumentState::kLocalMutations);
+  Document doc2_patched = Doc("rooms/eros/messages/2", 0, Map("sort", 0),
+                              DocumentState::kLocalMutations);
+  FieldMaskMap changed_fields{{doc1.key(), FieldMask{Field("sort")}},
+                              {doc2.key(), FieldMask{Field("sort")}}};
+  ViewDocumentChanges changes = view.ComputeDocumentChanges(
+      DocUpdates({doc1_patched, doc2_patched}), absl::nullopt, changed_fields);
+
+  EXPECT_TRUE(changes.needs_refill());
+  EXPECT_THAT(changes.document_set(), ElementsAre(doc2_patched));
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
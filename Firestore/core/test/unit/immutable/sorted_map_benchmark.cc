@@ -0,0 +1,316 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the immutable containers, keyed by the types the rest of
+// Firestore keys them by.
+//
+// Besides time, each benchmark reports the number of heap allocations and
+// allocated bytes per iteration, counted by replacing the global operator new
+// and delete in this binary.
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/immutable/append_only_list.h"
+#include "Firestore/core/src/immutable/sorted_map.h"
+#include "Firestore/core/src/immutable/sorted_set.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/types.h"
+#include "absl/strings/str_format.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// The benchmarks are single-threaded, so the counters don't need to be
+// atomic.
+size_t allocation_count = 0;
+size_t allocated_bytes = 0;
+
+void* CountedAllocate(size_t size) {
+  ++allocation_count;
+  allocated_bytes += size;
+  return std::malloc(size);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  void* ptr = CountedAllocate(size);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+namespace firebase {
+namespace firestore {
+namespace immutable {
+namespace {
+
+using model::DocumentKey;
+using model::TargetId;
+
+/**
+ * Counts the allocations made between its construction and `Report`, and
+ * reports them per iteration.
+ */
+class AllocationTracker {
+ public:
+  AllocationTracker()
+      : start_count_(allocation_count), start_bytes_(allocated_bytes) {
+  }
+
+  void Report(benchmark::State& state) const {
+    state.counters["allocs"] =
+        benchmark::Counter(static_cast<double>(allocation_count - start_count_),
+                           benchmark::Counter::kAvgIterations);
+    state.counters["alloc_bytes"] =
+        benchmark::Counter(static_cast<double>(allocated_bytes - start_bytes_),
+                           benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  size_t start_count_;
+  size_t start_bytes_;
+};
+
+template <typename K>
+K MakeKey(int64_t i);
+
+template <>
+DocumentKey MakeKey<DocumentKey>(int64_t i) {
+  return DocumentKey::FromPathString(absl::StrFormat("coll/doc%08d", i));
+}
+
+template <>
+std::string MakeKey<std::string>(int64_t i) {
+  return absl::StrFormat("key%08d", i);
+}
+
+template <>
+TargetId MakeKey<TargetId>(int64_t i) {
+  return static_cast<TargetId>(i);
+}
+
+/** Returns `count` distinct keys in a random but repeatable order. */
+template <typename K>
+std::vector<K> ShuffledKeys(int64_t count) {
+  std::vector<K> keys;
+  keys.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    keys.push_back(MakeKey<K>(i));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{42});
+  return keys;
+}
+
+template <typename K>
+SortedMap<K, int> MakeMap(const std::vector<K>& keys) {
+  SortedMap<K, int> map;
+  for (const K& key : keys) {
+    map = map.insert(key, 0);
+  }
+  return map;
+}
+
+template <typename K>
+void BM_SortedMapInsert(benchmark::State& state) {
+  std::vector<K> keys = ShuffledKeys<K>(state.range(0));
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(MakeMap(keys));
+  }
+  allocations.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename K>
+void BM_SortedMapErase(benchmark::State& state) {
+  std::vector<K> keys = ShuffledKeys<K>(state.range(0));
+  SortedMap<K, int> full = MakeMap(keys);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{7});
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    SortedMap<K, int> map = full;
+    for (const K& key : keys) {
+      map = map.erase(key);
+    }
+    benchmark::DoNotOptimize(map);
+  }
+  allocations.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename K>
+void BM_SortedMapFind(benchmark::State& state) {
+  std::vector<K> keys = ShuffledKeys<K>(state.range(0));
+  SortedMap<K, int> map = MakeMap(keys);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937{7});
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    for (const K& key : keys) {
+      benchmark::DoNotOptimize(map.find(key));
+    }
+  }
+  allocations.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename K>
+void BM_SortedMapIterate(benchmark::State& state) {
+  SortedMap<K, int> map = MakeMap(ShuffledKeys<K>(state.range(0)));
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    for (const auto& entry : map) {
+      benchmark::DoNotOptimize(entry);
+    }
+  }
+  allocations.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename K>
+void BM_SortedMapCopy(benchmark::State& state) {
+  SortedMap<K, int> map = MakeMap(ShuffledKeys<K>(state.range(0)));
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    SortedMap<K, int> copy = map;
+    benchmark::DoNotOptimize(copy);
+  }
+  allocations.Report(state);
+}
+
+// Inserts the entry that no longer fits in the fixed-size array
+// representation, which converts the map to a tree.
+template <typename K>
+void BM_SortedMapPromoteToTree(benchmark::State& state) {
+  std::vector<K> keys = ShuffledKeys<K>(SortedMapBase::kFixedSize + 1);
+  K last = keys.back();
+  keys.pop_back();
+  SortedMap<K, int> full = MakeMap(keys);
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(full.insert(last, 0));
+  }
+  allocations.Report(state);
+}
+
+template <typename K>
+void BM_SortedSetInsert(benchmark::State& state) {
+  std::vector<K> keys = ShuffledKeys<K>(state.range(0));
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    SortedSet<K> set;
+    for (const K& key : keys) {
+      set = set.insert(key);
+    }
+    benchmark::DoNotOptimize(set);
+  }
+  allocations.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename K>
+void BM_AppendOnlyListPushBack(benchmark::State& state) {
+  std::vector<K> keys = ShuffledKeys<K>(state.range(0));
+
+  AllocationTracker allocations;
+  for (auto _ : state) {
+    AppendOnlyList<K> list;
+    for (const K& key : keys) {
+      list = list.push_back(key);
+    }
+    benchmark::DoNotOptimize(list);
+  }
+  allocations.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define SIZED_BENCHMARK(name, K)        \
+  BENCHMARK_TEMPLATE(name, K)           \
+      ->RangeMultiplier(10)             \
+      ->Range(10, 1000000)              \
+      ->Unit(benchmark::kMicrosecond)
+
+#define KEYED_BENCHMARK(name)           \
+  SIZED_BENCHMARK(name, DocumentKey);   \
+  SIZED_BENCHMARK(name, std::string);   \
+  SIZED_BENCHMARK(name, TargetId)
+
+KEYED_BENCHMARK(BM_SortedMapInsert);
+KEYED_BENCHMARK(BM_SortedMapErase);
+KEYED_BENCHMARK(BM_SortedMapFind);
+KEYED_BENCHMARK(BM_SortedMapIterate);
+KEYED_BENCHMARK(BM_SortedMapCopy);
+KEYED_BENCHMARK(BM_SortedSetInsert);
+KEYED_BENCHMARK(BM_AppendOnlyListPushBack);
+
+BENCHMARK_TEMPLATE(BM_SortedMapPromoteToTree, DocumentKey);
+BENCHMARK_TEMPLATE(BM_SortedMapPromoteToTree, std::string);
+BENCHMARK_TEMPLATE(BM_SortedMapPromoteToTree, TargetId);
+
+}  // namespace
+}  // namespace immutable
+}  // namespace firestore
+}  // namespace firebase
@@ -122,6 +122,26 @@ TYPED_TEST(SortedMapTest, Increasing) {
   ASSERT_EQ(Pairs(empty), Collect(map));
 }
 
+TYPED_TEST(SortedMapTest, CreateFromSorted) {
+  for (int n = 0; n <= this->large_number(); ++n) {
+    std::vector<std::pair<int, int>> entries = Pairs(Sequence(n));
+    TypeParam map = TypeParam::CreateFromSorted(entries, {});
+    ASSERT_EQ(static_cast<SizeType>(n), map.size());
+    ASSERT_EQ(entries, Collect(map));
+
+    for (int i = 0; i < n; ++i) {
+      ASSERT_TRUE(Found(map, i, i));
+    }
+    ASSERT_TRUE(NotFound(map, n));
+
+    // The result must remain usable as the basis for further modification.
+    for (int i = 0; i < n; i += 2) {
+      map = map.erase(i);
+    }
+    ASSERT_EQ(Pairs(Sequence(1, n, 2)), Collect(map));
+  }
+}
+
 TYPED_TEST(SortedMapTest, Overwrite) {
   TypeParam map = TypeParam().insert(10, 10).insert(10, 8);
 
@@ -29,6 +29,37 @@ namespace impl {
 
 using IntMap = TreeSortedMap<int, int>;
 
+namespace {
+
+/**
+ * Returns the number of black nodes on every path from the given node to a
+ * leaf, or -1 if the paths disagree or the node violates the left-leaning
+ * red-black invariants.
+ */
+int BlackHeight(const IntMap::node_type& node) {
+  if (node.empty()) {
+    return 0;
+  }
+  if (node.right().red()) {
+    return -1;
+  }
+  if (node.red() && node.left().red()) {
+    return -1;
+  }
+  if (node.size() != node.left().size() + 1 + node.right().size()) {
+    return -1;
+  }
+
+  int left = BlackHeight(node.left());
+  int right = BlackHeight(node.right());
+  if (left < 0 || left != right) {
+    return -1;
+  }
+  return left + (node.red() ? 0 : 1);
+}
+
+}  // namespace
+
 TEST(TreeSortedMap, EmptySize) {
   IntMap map;
   EXPECT_TRUE(map.empty());
@@ -230,6 +261,18 @@ TEST(TreeSortedMap, InitializerIsSorted) {
   EXPECT_TRUE(std::is_sorted(map.begin(), map.end()));
 }
 
+TEST(TreeSortedMap, CreateFromSortedIsBalanced) {
+  for (int n = 0; n < 300; ++n) {
+    IntMap map = IntMap::CreateFromSorted(Pairs(Sequence(n)), {});
+    EXPECT_FALSE(map.root().red());
+    ASSERT_NE(-1, BlackHeight(map.root())) << "size " << n;
+    ASSERT_EQ(Pairs(Sequence(n)), Collect(map));
+
+    IntMap modified = map.insert(n, n).erase(0);
+    ASSERT_NE(-1, BlackHeight(modified.root())) << "size " << n;
+  }
+}
+
 }  // namespace impl
 }  // namespace immutable
 }  // namespace firestore
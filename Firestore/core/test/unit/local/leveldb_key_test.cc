@@ -251,6 +251,28 @@ TEST(LevelDbTargetKeyTest, Description) {
                                LevelDbTargetKey::Key(42));
 }
 
+TEST(LevelDbTargetStateKeyTest, EncodeDecodeCycle) {
+  LevelDbTargetStateKey key;
+  TargetId target_id = 42;
+
+  auto encoded = LevelDbTargetStateKey::Key(42);
+  bool ok = key.Decode(encoded);
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(target_id, key.target_id());
+}
+
+TEST(LevelDbTargetStateKeyTest, DoesNotDecodeTargetKeys) {
+  LevelDbTargetStateKey key;
+  ASSERT_FALSE(key.Decode(LevelDbTargetKey::Key(42)));
+  ASSERT_FALSE(absl::StartsWith(LevelDbTargetStateKey::Key(42),
+                                LevelDbTargetKey::KeyPrefix()));
+}
+
+TEST(LevelDbTargetStateKeyTest, Description) {
+  AssertExpectedKeyDescription("[target_state: target_id=42]",
+                               LevelDbTargetStateKey::Key(42));
+}
+
 TEST(LevelDbQueryTargetKeyTest, EncodeDecodeCycle) {
   LevelDbQueryTargetKey key;
   std::string canonical_id("foo");
@@ -424,6 +446,58 @@ TEST(RemoteDocumentReadTimeKeyTest, Description) {
       RemoteDocumentReadTimeKey("coll", 1000001, "doc"));
 }
 
+TEST(CollectionGroupDocumentKeyTest, Prefixing) {
+  auto table_key = LevelDbCollectionGroupDocumentKey::KeyPrefix();
+  auto messages_key = LevelDbCollectionGroupDocumentKey::KeyPrefix("messages");
+
+  ASSERT_TRUE(absl::StartsWith(messages_key, table_key));
+  ASSERT_TRUE(absl::StartsWith(
+      LevelDbCollectionGroupDocumentKey::Key(testutil::Key("messages/1")),
+      messages_key));
+  ASSERT_TRUE(absl::StartsWith(LevelDbCollectionGroupDocumentKey::Key(
+                                   testutil::Key("rooms/a/messages/1")),
+                               messages_key));
+
+  // This is critical: messages2 should not contain messages.
+  ASSERT_FALSE(absl::StartsWith(
+      LevelDbCollectionGroupDocumentKey::Key(testutil::Key("messages2/1")),
+      messages_key));
+}
+
+TEST(CollectionGroupDocumentKeyTest, EncodeDecodeCycle) {
+  LevelDbCollectionGroupDocumentKey key;
+
+  std::vector<std::string> paths{"messages/1", "rooms/a/messages/1",
+                                 "rooms/a/messages/1/replies/2"};
+  for (auto&& path : paths) {
+    auto encoded =
+        LevelDbCollectionGroupDocumentKey::Key(testutil::Key(path));
+    bool ok = key.Decode(encoded);
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(testutil::Key(path), key.document_key());
+    ASSERT_EQ(key.document_key().path().PopLast().last_segment(),
+              key.collection_id());
+  }
+}
+
+TEST(CollectionGroupDocumentKeyTest, EncodeDecodeReadTimeValue) {
+  std::vector<int64_t> versions{0, 1, 1000000, 1000001};
+  for (auto version : versions) {
+    auto encoded = LevelDbCollectionGroupDocumentKey::EncodeReadTimeValue(
+        testutil::Version(version));
+    ASSERT_EQ(testutil::Version(version),
+              LevelDbCollectionGroupDocumentKey::DecodeReadTimeValue(encoded));
+  }
+}
+
+TEST(CollectionGroupDocumentKeyTest, Description) {
+  AssertExpectedKeyDescription(
+      "[collection_group_document: collection_id=messages "
+      "path=rooms/a/messages/1]",
+      LevelDbCollectionGroupDocumentKey::Key(
+          testutil::Key("rooms/a/messages/1")));
+}
+
 TEST(BundleKeyTest, Prefixing) {
   auto table_key = LevelDbBundleKey::KeyPrefix();
 
@@ -45,6 +45,7 @@ using leveldb::Status;
 using model::BatchId;
 using model::DocumentKey;
 using model::ListenSequenceNumber;
+using model::SnapshotVersion;
 using model::TargetId;
 using nanopb::Message;
 using testutil::Key;
@@ -459,6 +460,95 @@ TEST_F(LevelDbMigrationsTest, CreateCollectionParentsIndex) {
   }
 }
 
+TEST_F(LevelDbMigrationsTest, CreateCollectionGroupDocumentsIndex) {
+  // This test creates a database with schema version 6 that has a few remote
+  // documents with read times and then ensures that appropriate entries are
+  // written to the collection_group_document index.
+  std::string empty_buffer;
+  LevelDbMigrations::RunMigrations(db_.get(), 6);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write Remote Documents");
+    for (auto remote_doc_path : {"cg1/a", "cg1/b", "x/y/cg1/c", "cg2/d"}) {
+      DocumentKey key = DocumentKey::FromPathString(remote_doc_path);
+      transaction.Put(LevelDbRemoteDocumentKey::Key(key), empty_buffer);
+    }
+
+    // cg1/a was read twice, and the latest read time should win. x/y/cg1/c
+    // was never assigned a read time, and cg1/gone is no longer cached.
+    transaction.Put(LevelDbRemoteDocumentReadTimeKey::Key(
+                        testutil::Resource("cg1"), testutil::Version(1), "a"),
+                    empty_buffer);
+    transaction.Put(LevelDbRemoteDocumentReadTimeKey::Key(
+                        testutil::Resource("cg1"), testutil::Version(3), "a"),
+                    empty_buffer);
+    transaction.Put(LevelDbRemoteDocumentReadTimeKey::Key(
+                        testutil::Resource("cg1"), testutil::Version(2), "b"),
+                    empty_buffer);
+    transaction.Put(
+        LevelDbRemoteDocumentReadTimeKey::Key(testutil::Resource("cg1"),
+                                              testutil::Version(4), "gone"),
+        empty_buffer);
+    transaction.Put(LevelDbRemoteDocumentReadTimeKey::Key(
+                        testutil::Resource("cg2"), testutil::Version(5), "d"),
+                    empty_buffer);
+
+    transaction.Commit();
+  }
+
+  // Migrate to v7 and verify index entries.
+  LevelDbMigrations::RunMigrations(db_.get(), 7);
+  {
+    LevelDbTransaction transaction(db_.get(), "Verify");
+
+    std::map<std::string, SnapshotVersion> actual_read_times;
+    std::map<std::string, SnapshotVersion> expected_read_times{
+        {"cg1/a", testutil::Version(3)},
+        {"cg1/b", testutil::Version(2)},
+        {"x/y/cg1/c", SnapshotVersion::None()},
+        {"cg2/d", testutil::Version(5)}};
+    auto index_iterator = transaction.NewIterator();
+    std::string index_prefix = LevelDbCollectionGroupDocumentKey::KeyPrefix();
+    LevelDbCollectionGroupDocumentKey row_key;
+    for (index_iterator->Seek(index_prefix); index_iterator->Valid();
+         index_iterator->Next()) {
+      if (!absl::StartsWith(index_iterator->key(), index_prefix) ||
+          !row_key.Decode(index_iterator->key()))
+        break;
+
+      actual_read_times[row_key.document_key().ToString()] =
+          LevelDbCollectionGroupDocumentKey::DecodeReadTimeValue(
+              index_iterator->value());
+    }
+
+    ASSERT_EQ(actual_read_times, expected_read_times);
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, DropsTargetStates) {
+  // This test simulates target states left behind by a client that was
+  // downgraded to version 7, which updates the targets' own rows, and then
+  // upgraded again.
+  LevelDbMigrations::RunMigrations(db_.get(), 7);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write Targets");
+    for (TargetId target_id : {1, 2}) {
+      transaction.Put(LevelDbTargetKey::Key(target_id), "");
+      transaction.Put(LevelDbTargetStateKey::Key(target_id), "");
+    }
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 8);
+  {
+    LevelDbTransaction transaction(db_.get(), "Verify");
+    for (TargetId target_id : {1, 2}) {
+      ASSERT_THAT(LevelDbTargetKey::Key(target_id), IsFound(&transaction));
+      ASSERT_THAT(LevelDbTargetStateKey::Key(target_id),
+                  IsNotFound(&transaction));
+    }
+  }
+}
+
 TEST_F(LevelDbMigrationsTest, CanDowngrade) {
   // First, run all of the migrations
   LevelDbMigrations::RunMigrations(db_.get());
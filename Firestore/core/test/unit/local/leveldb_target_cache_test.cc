@@ -16,9 +16,13 @@
 
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 
+#include <string>
+#include <vector>
+
 #include "Firestore/core/include/firebase/firestore/timestamp.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_transaction.h"
 #include "Firestore/core/src/local/persistence.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document_key.h"
@@ -151,6 +155,95 @@ TEST_F(LevelDbTargetCacheTest, SurvivesMissingTargetData) {
   });
 }
 
+TEST_F(LevelDbTargetCacheTest, UpdatesWriteOnlyTheTargetState) {
+  persistence_->Run("test_updates_write_only_the_target_state", [&]() {
+    TargetData target_data = MakeTargetData(query_rooms_, 1, 10, 1);
+    cache_->AddTarget(target_data);
+
+    LevelDbTransaction* transaction =
+        leveldb_persistence()->current_transaction();
+    std::string target_key = LevelDbTargetKey::Key(1);
+    std::string state_key = LevelDbTargetStateKey::Key(1);
+    std::string added_target;
+    std::string state;
+    ASSERT_TRUE(transaction->Get(target_key, &added_target).ok());
+    ASSERT_TRUE(transaction->Get(state_key, &state).IsNotFound());
+
+    TargetData updated = MakeTargetData(query_rooms_, 1, 11, 2);
+    cache_->UpdateTarget(updated);
+
+    std::string target;
+    ASSERT_TRUE(transaction->Get(target_key, &target).ok());
+    ASSERT_EQ(target, added_target);
+    ASSERT_TRUE(transaction->Get(state_key, &state).ok());
+    ASSERT_EQ(cache_->GetTarget(query_rooms_.ToTarget()), updated);
+
+    cache_->RemoveTarget(updated);
+    ASSERT_TRUE(transaction->Get(target_key, &target).IsNotFound());
+    ASSERT_TRUE(transaction->Get(state_key, &state).IsNotFound());
+  });
+}
+
+TEST_F(LevelDbTargetCacheTest, ScansTargetsAlongsideTheirStates) {
+  persistence_->Run("test_scans_targets_alongside_their_states", [&]() {
+    // Only every other target has a state row, so the two tables are out of
+    // step while they are scanned together.
+    std::vector<TargetData> updated;
+    for (TargetId target_id = 1; target_id <= 4; ++target_id) {
+      TargetData target_data = MakeTargetData(
+          testutil::Query(std::to_string(target_id)), target_id, 10, 1);
+      cache_->AddTarget(target_data);
+      if (target_id % 2 == 0) {
+        updated.push_back(target_data.WithSequenceNumber(30));
+        cache_->UpdateTarget(updated.back());
+      }
+    }
+
+    std::vector<ListenSequenceNumber> sequence_numbers;
+    cache_->EnumerateSequenceNumbers([&](ListenSequenceNumber sequence_number) {
+      sequence_numbers.push_back(sequence_number);
+    });
+    ASSERT_EQ(sequence_numbers,
+              (std::vector<ListenSequenceNumber>{10, 30, 10, 30}));
+
+    ASSERT_EQ(cache_->RemoveTargets(20, {}), 2u);
+    for (const TargetData& target_data : updated) {
+      ASSERT_EQ(cache_->GetTarget(target_data.target()), target_data);
+    }
+
+    std::string state;
+    ASSERT_TRUE(leveldb_persistence()
+                    ->current_transaction()
+                    ->Get(LevelDbTargetStateKey::Key(2), &state)
+                    .ok());
+  });
+}
+
+TEST_F(LevelDbTargetCacheTest, TargetStatePersistedAcrossRestarts) {
+  persistence_->Shutdown();
+  persistence_.reset();
+
+  Path dir = LevelDbDir();
+
+  TargetData updated = MakeTargetData(query_rooms_, 1, 11, 2);
+  {
+    auto db1 = LevelDbPersistenceForTesting(dir);
+    LevelDbTargetCache* target_cache = db1->target_cache();
+    db1->Run("Add and update target", [&] {
+      target_cache->AddTarget(MakeTargetData(query_rooms_, 1, 10, 1));
+      target_cache->UpdateTarget(updated);
+    });
+    db1->Shutdown();
+  }
+
+  auto db2 = LevelDbPersistenceForTesting(dir);
+  db2->Run("Verify target", [&] {
+    ASSERT_EQ(db2->target_cache()->GetTarget(query_rooms_.ToTarget()),
+              updated);
+  });
+  db2->Shutdown();
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -642,6 +642,37 @@ TEST_F(LocalSerializerTest, EncodesTargetDataWithDocumentQuery) {
   ExpectRoundTrip(target_data, expected);
 }
 
+TEST_F(LocalSerializerTest, EncodesTargetState) {
+  core::Query query = Query("room");
+  TargetId target_id = 42;
+  TargetData target_data(query.ToTarget(), target_id, 10,
+                         QueryPurpose::Listen);
+  ByteString resume_token = testutil::ResumeToken(1039);
+  TargetData updated =
+      target_data.WithSequenceNumber(20)
+          .WithResumeToken(resume_token, testutil::Version(1039))
+          .WithLastLimboFreeSnapshotVersion(testutil::Version(1000));
+
+  ::firestore::client::Target expected;
+  expected.set_target_id(target_id);
+  expected.set_last_listen_sequence_number(20);
+  expected.mutable_snapshot_version()->set_nanos(1039000);
+  expected.mutable_last_limbo_free_snapshot_version()->set_nanos(1000000);
+  expected.set_resume_token(resume_token.data(), resume_token.size());
+
+  ByteString bytes = MakeByteString(serializer.EncodeTargetState(updated));
+  auto actual = ProtobufParse<::firestore::client::Target>(bytes);
+  EXPECT_TRUE(msg_diff.Compare(expected, actual)) << message_differences;
+
+  StringReader reader(bytes);
+  auto message = Message<firestore_client_Target>::TryParse(&reader);
+  TargetData decoded =
+      serializer.DecodeTargetState(&reader, *message, target_data);
+
+  EXPECT_OK(reader.status());
+  EXPECT_EQ(decoded, updated);
+}
+
 TEST_F(LocalSerializerTest, EncodesNamedQuery) {
   auto now = Timestamp::Now();
   Target t =
@@ -0,0 +1,533 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the LocalStore operations that the sync engine performs:
+// writing and acknowledging mutations, applying remote events, executing
+// queries, updating local views and collecting garbage.
+//
+// Every benchmark takes three arguments: the number of documents in the
+// remote document cache, the number of pending (unacknowledged) writes, and
+// the number of fields in each document. Besides throughput, each benchmark
+// reports the median and 99th percentile latency of a single operation.
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/include/firebase/firestore/timestamp.h"
+#include "Firestore/core/src/auth/user.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/local_view_changes.h"
+#include "Firestore/core/src/local/local_write_result.h"
+#include "Firestore/core/src/local/lru_garbage_collector.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/local/reference_delegate.h"
+#include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/field_value.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/mutation_batch.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/remote/remote_event.h"
+#include "Firestore/core/src/remote/watch_change.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/fake_target_metadata_provider.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_format.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using auth::User;
+using model::Document;
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::FieldValue;
+using model::Mutation;
+using model::MutationBatch;
+using model::MutationBatchResult;
+using model::MutationResult;
+using model::TargetId;
+using remote::DocumentWatchChange;
+using remote::FakeTargetMetadataProvider;
+using remote::RemoteEvent;
+using remote::WatchChangeAggregator;
+using remote::WatchTargetChange;
+using remote::WatchTargetChangeState;
+using testutil::Doc;
+using testutil::Query;
+using testutil::Version;
+
+// The documents are spread evenly over this many collections, each of which
+// has an active listen.
+const int kTargetCount = 10;
+
+// The number of documents each remote event changes in each target.
+const int kDocumentsPerTarget = 10;
+
+// The number of documents that become eligible for garbage collection before
+// each collection.
+const int kOrphanedDocuments = 100;
+
+// Collect every document that isn't referenced, as soon as it is asked to.
+const LruParams kLruParams{/* min_bytes_threshold= */ 0,
+                           /* percentile_to_collect= */ 100,
+                           /* maximum_sequence_numbers_to_collect= */ 1000};
+
+using PersistenceFactory = std::unique_ptr<Persistence> (*)();
+
+std::unique_ptr<Persistence> MakeMemoryPersistence() {
+  return MemoryPersistenceWithLruGcForTesting(kLruParams);
+}
+
+std::unique_ptr<Persistence> MakeLevelDbPersistence() {
+  return LevelDbPersistenceForTesting(kLruParams);
+}
+
+/** Records the latency of each operation, to report its distribution. */
+class LatencyRecorder {
+ public:
+  template <typename F>
+  void Measure(F&& operation) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    operation();
+    micros_.push_back(
+        std::chrono::duration<double, std::micro>(Clock::now() - start)
+            .count());
+  }
+
+  void Report(benchmark::State& state) {
+    if (micros_.empty()) return;
+
+    std::sort(micros_.begin(), micros_.end());
+    state.counters["p50_us"] = Percentile(50);
+    state.counters["p99_us"] = Percentile(99);
+  }
+
+ private:
+  double Percentile(size_t percentile) const {
+    size_t index = (micros_.size() - 1) * percentile / 100;
+    return micros_[index];
+  }
+
+  std::vector<double> micros_;
+};
+
+/**
+ * A LocalStore whose remote document cache holds `state.range(0)` documents
+ * of `state.range(2)` fields each, spread over `kTargetCount` listened
+ * collections, and whose mutation queue holds `state.range(1)` pending writes.
+ */
+class LocalStoreHarness {
+ public:
+  LocalStoreHarness(PersistenceFactory factory, const benchmark::State& state)
+      : persistence_(factory()),
+        local_store_(persistence_.get(), &query_engine_,
+                     User::Unauthenticated()),
+        document_count_(state.range(0)),
+        width_(state.range(2)) {
+    local_store_.Start();
+
+    for (int i = 0; i < kTargetCount; ++i) {
+      TargetData target_data =
+          local_store_.AllocateTarget(CollectionQuery(i).ToTarget());
+      targets_.push_back(target_data);
+      target_keys_.emplace_back();
+    }
+
+    // Load the whole collection in a single snapshot and raise the views, so
+    // that queries can be executed from their previous results.
+    std::vector<int64_t> indexes;
+    for (int64_t i = 0; i < document_count_; ++i) {
+      indexes.push_back(i);
+    }
+    local_store_.ApplyRemoteEvent(MakeRemoteEvent(indexes));
+
+    std::vector<LocalViewChanges> view_changes;
+    for (int i = 0; i < kTargetCount; ++i) {
+      view_changes.emplace_back(targets_[i].target_id(),
+                                /* from_cache= */ false, target_keys_[i],
+                                DocumentKeySet{});
+    }
+    local_store_.NotifyLocalViewChanges(view_changes);
+
+    for (int64_t i = 0; i < state.range(1); ++i) {
+      WriteMutation();
+    }
+  }
+
+  ~LocalStoreHarness() {
+    persistence_->Shutdown();
+  }
+
+  LocalStore* local_store() {
+    return &local_store_;
+  }
+
+  const std::vector<TargetData>& targets() const {
+    return targets_;
+  }
+
+  const DocumentKeySet& target_keys(int target) const {
+    return target_keys_[target];
+  }
+
+  size_t pending_writes() const {
+    return pending_batches_.size();
+  }
+
+  LruGarbageCollector* garbage_collector() {
+    return static_cast<LruDelegate*>(persistence_->reference_delegate())
+        ->garbage_collector();
+  }
+
+  static core::Query CollectionQuery(int target) {
+    return Query(absl::StrFormat("coll%d", target));
+  }
+
+  /** Overwrites the next document with a local set mutation. */
+  void WriteMutation() {
+    int64_t index = NextIndex();
+    std::vector<Mutation> mutations{
+        testutil::SetMutation(DocumentPath(index), DocumentData(index))};
+
+    auto mutations_copy = mutations;
+    LocalWriteResult result =
+        local_store_.WriteLocally(std::move(mutations_copy));
+    pending_batches_.emplace_back(result.batch_id(), Timestamp::Now(),
+                                  std::vector<Mutation>{},
+                                  std::move(mutations));
+  }
+
+  /** Acknowledges the oldest pending write. */
+  void AcknowledgeMutation() {
+    MutationBatch batch = std::move(pending_batches_.front());
+    pending_batches_.pop_front();
+
+    model::SnapshotVersion version = Version(NextVersion());
+    std::vector<MutationResult> results(
+        batch.mutations().size(), MutationResult(version, absl::nullopt));
+    local_store_.AcknowledgeBatch(
+        MutationBatchResult(std::move(batch), version, std::move(results), {}));
+  }
+
+  /**
+   * Returns a remote event that updates `kDocumentsPerTarget` documents in
+   * each listened collection.
+   */
+  RemoteEvent MakeUpdateEvent() {
+    std::vector<int64_t> indexes;
+    for (int i = 0; i < kTargetCount * kDocumentsPerTarget; ++i) {
+      indexes.push_back(NextIndex());
+    }
+    return MakeRemoteEvent(indexes);
+  }
+
+  /**
+   * Listens to a new collection of `kOrphanedDocuments` documents and stops
+   * listening again, leaving the documents and the target unreferenced.
+   */
+  void OrphanDocuments() {
+    int64_t version = NextVersion();
+    std::string collection = absl::StrFormat("orphans%d", version);
+    TargetData target_data =
+        local_store_.AllocateTarget(Query(collection).ToTarget());
+    TargetId target_id = target_data.target_id();
+
+    auto metadata_provider =
+        FakeTargetMetadataProvider::CreateEmptyResultProvider(
+            testutil::Resource(collection), {target_id});
+    WatchChangeAggregator aggregator{&metadata_provider};
+    for (int i = 0; i < kOrphanedDocuments; ++i) {
+      Document doc = Doc(absl::StrFormat("%s/doc%08d", collection, i), version,
+                         DocumentData(i));
+      aggregator.HandleDocumentChange(
+          DocumentWatchChange{{target_id}, {}, doc.key(), doc});
+    }
+    aggregator.HandleTargetChange(
+        WatchTargetChange{WatchTargetChangeState::Current,
+                          {target_id},
+                          testutil::ResumeToken(version)});
+    local_store_.ApplyRemoteEvent(
+        aggregator.CreateRemoteEvent(Version(version)));
+
+    local_store_.ReleaseTarget(target_id);
+  }
+
+ private:
+  int64_t NextVersion() {
+    return ++version_;
+  }
+
+  /** Cycles through the documents, visiting every collection in turn. */
+  int64_t NextIndex() {
+    int64_t index = next_index_;
+    next_index_ = (next_index_ + 1) % document_count_;
+    return index;
+  }
+
+  std::string DocumentPath(int64_t index) const {
+    return absl::StrFormat("coll%d/doc%08d", index % kTargetCount, index);
+  }
+
+  FieldValue::Map DocumentData(int64_t index) const {
+    FieldValue::Map data;
+    data = data.insert("index", FieldValue::FromInteger(index));
+    for (int64_t i = 0; i < width_; ++i) {
+      data = data.insert(absl::StrFormat("field%d", i),
+                         FieldValue::FromString(std::string(20, 'x')));
+    }
+    return data;
+  }
+
+  /**
+   * Returns a remote event that adds or updates the documents with the given
+   * indexes in the targets listening to their collections, and marks those
+   * targets current.
+   */
+  RemoteEvent MakeRemoteEvent(const std::vector<int64_t>& indexes) {
+    int64_t version = NextVersion();
+
+    FakeTargetMetadataProvider metadata_provider;
+    std::vector<TargetId> target_ids;
+    for (int i = 0; i < kTargetCount; ++i) {
+      metadata_provider.SetSyncedKeys(target_keys_[i], targets_[i]);
+      target_ids.push_back(targets_[i].target_id());
+    }
+
+    WatchChangeAggregator aggregator{&metadata_provider};
+    for (int64_t index : indexes) {
+      Document doc = Doc(DocumentPath(index), version, DocumentData(index));
+      int64_t target = index % kTargetCount;
+      aggregator.HandleDocumentChange(DocumentWatchChange{
+          {targets_[target].target_id()}, {}, doc.key(), doc});
+      target_keys_[target] = target_keys_[target].insert(doc.key());
+    }
+    aggregator.HandleTargetChange(
+        WatchTargetChange{WatchTargetChangeState::Current, target_ids,
+                          testutil::ResumeToken(version)});
+    return aggregator.CreateRemoteEvent(Version(version));
+  }
+
+  std::unique_ptr<Persistence> persistence_;
+  QueryEngine query_engine_;
+  LocalStore local_store_;
+
+  int64_t document_count_ = 0;
+  int64_t width_ = 0;
+  int64_t version_ = 0;
+  int64_t next_index_ = 0;
+
+  std::vector<TargetData> targets_;
+  std::vector<DocumentKeySet> target_keys_;
+  std::deque<MutationBatch> pending_batches_;
+};
+
+// Writes a mutation and acknowledges the oldest pending one, so that the
+// number of pending writes stays the same.
+void BM_LocalStoreWriteAndAcknowledge(benchmark::State& state,
+                                      PersistenceFactory factory) {
+  LocalStoreHarness harness(factory, state);
+  size_t pending_writes = harness.pending_writes();
+  LatencyRecorder latency;
+
+  for (auto _ : state) {
+    latency.Measure([&] {
+      harness.WriteMutation();
+      while (harness.pending_writes() > pending_writes) {
+        harness.AcknowledgeMutation();
+      }
+    });
+  }
+  state.SetItemsProcessed(state.iterations());
+  latency.Report(state);
+}
+
+void BM_LocalStoreApplyRemoteEvent(benchmark::State& state,
+                                   PersistenceFactory factory) {
+  LocalStoreHarness harness(factory, state);
+  LatencyRecorder latency;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    RemoteEvent event = harness.MakeUpdateEvent();
+    state.ResumeTiming();
+
+    latency.Measure([&] { harness.local_store()->ApplyRemoteEvent(event); });
+  }
+  state.SetItemsProcessed(state.iterations() * kTargetCount *
+                          kDocumentsPerTarget);
+  latency.Report(state);
+}
+
+void BM_LocalStoreExecuteQuery(benchmark::State& state,
+                               PersistenceFactory factory,
+                               bool use_previous_results) {
+  LocalStoreHarness harness(factory, state);
+  core::Query query = LocalStoreHarness::CollectionQuery(0);
+  LatencyRecorder latency;
+
+  for (auto _ : state) {
+    latency.Measure([&] {
+      benchmark::DoNotOptimize(
+          harness.local_store()->ExecuteQuery(query, use_previous_results));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * harness.target_keys(0).size());
+  latency.Report(state);
+}
+
+// Alternately adds documents to and removes them from every view.
+void BM_LocalStoreNotifyLocalViewChanges(benchmark::State& state,
+                                         PersistenceFactory factory) {
+  LocalStoreHarness harness(factory, state);
+  LatencyRecorder latency;
+
+  std::vector<DocumentKeySet> changed_keys;
+  for (int i = 0; i < kTargetCount; ++i) {
+    DocumentKeySet keys;
+    for (const DocumentKey& key : harness.target_keys(i)) {
+      if (keys.size() == static_cast<size_t>(kDocumentsPerTarget)) break;
+      keys = keys.insert(key);
+    }
+    changed_keys.push_back(keys);
+  }
+
+  bool add = true;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<LocalViewChanges> view_changes;
+    for (int i = 0; i < kTargetCount; ++i) {
+      view_changes.emplace_back(harness.targets()[i].target_id(),
+                                /* from_cache= */ false,
+                                add ? changed_keys[i] : DocumentKeySet{},
+                                add ? DocumentKeySet{} : changed_keys[i]);
+    }
+    add = !add;
+    state.ResumeTiming();
+
+    latency.Measure(
+        [&] { harness.local_store()->NotifyLocalViewChanges(view_changes); });
+  }
+  state.SetItemsProcessed(state.iterations() * kTargetCount);
+  latency.Report(state);
+}
+
+void BM_LocalStoreCollectGarbage(benchmark::State& state,
+                                 PersistenceFactory factory) {
+  LocalStoreHarness harness(factory, state);
+  LruGarbageCollector* garbage_collector = harness.garbage_collector();
+  LatencyRecorder latency;
+  int64_t documents_removed = 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    harness.OrphanDocuments();
+    state.ResumeTiming();
+
+    latency.Measure([&] {
+      LruResults results =
+          harness.local_store()->CollectGarbage(garbage_collector);
+      documents_removed += results.documents_removed;
+    });
+  }
+  state.SetItemsProcessed(documents_removed);
+  latency.Report(state);
+}
+
+// Documents in the cache, pending writes, and fields per document.
+void LocalStoreArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"docs", "pending", "width"});
+  for (int64_t documents : {1000, 10000, 100000}) {
+    for (int64_t pending_writes : {0, 100}) {
+      for (int64_t width : {10, 100}) {
+        benchmark->Args({documents, pending_writes, width});
+      }
+    }
+  }
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_CAPTURE(BM_LocalStoreWriteAndAcknowledge,
+                  Memory,
+                  MakeMemoryPersistence)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreWriteAndAcknowledge,
+                  LevelDb,
+                  MakeLevelDbPersistence)
+    ->Apply(LocalStoreArguments);
+
+BENCHMARK_CAPTURE(BM_LocalStoreApplyRemoteEvent, Memory, MakeMemoryPersistence)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreApplyRemoteEvent,
+                  LevelDb,
+                  MakeLevelDbPersistence)
+    ->Apply(LocalStoreArguments);
+
+BENCHMARK_CAPTURE(BM_LocalStoreExecuteQuery,
+                  Memory/FullScan,
+                  MakeMemoryPersistence,
+                  false)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreExecuteQuery,
+                  Memory/PreviousResults,
+                  MakeMemoryPersistence,
+                  true)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreExecuteQuery,
+                  LevelDb/FullScan,
+                  MakeLevelDbPersistence,
+                  false)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreExecuteQuery,
+                  LevelDb/PreviousResults,
+                  MakeLevelDbPersistence,
+                  true)
+    ->Apply(LocalStoreArguments);
+
+BENCHMARK_CAPTURE(BM_LocalStoreNotifyLocalViewChanges,
+                  Memory,
+                  MakeMemoryPersistence)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreNotifyLocalViewChanges,
+                  LevelDb,
+                  MakeLevelDbPersistence)
+    ->Apply(LocalStoreArguments);
+
+BENCHMARK_CAPTURE(BM_LocalStoreCollectGarbage, Memory, MakeMemoryPersistence)
+    ->Apply(LocalStoreArguments);
+BENCHMARK_CAPTURE(BM_LocalStoreCollectGarbage, LevelDb, MakeLevelDbPersistence)
+    ->Apply(LocalStoreArguments);
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -31,6 +31,7 @@
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/delete_mutation.h"
 #include "Firestore/core/src/model/document_map.h"
+#include "Firestore/core/src/model/field_mask.h"
 #include "Firestore/core/src/model/mutation_batch_result.h"
 #include "Firestore/core/src/model/no_document.h"
 #include "Firestore/core/src/model/patch_mutation.h"
@@ -58,6 +59,7 @@ using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentState;
+using model::FieldMask;
 using model::FieldValue;
 using model::ListenSequenceNumber;
 using model::MaybeDocument;
@@ -434,6 +436,54 @@ TEST_P(LocalStoreTest, HandlesSetMutation) {
   }
 }
 
+TEST_P(LocalStoreTest, ReportsFieldsChangedByPatches) {
+  LocalWriteResult result = local_store_.WriteLocally({
+      testutil::PatchMutation("foo/a", Map("x", 1)),
+      testutil::PatchMutation("foo/a", Map("y", 1),
+                              {testutil::Increment("z", Value(1))}),
+      testutil::SetMutation("foo/b", Map("x", 1)),
+      testutil::PatchMutation("foo/b", Map("y", 1)),
+      testutil::DeleteMutation("foo/c"),
+  });
+
+  // Any field of the documents that weren't just patched may have changed.
+  ASSERT_EQ(result.changed_fields().size(), 1);
+  EXPECT_EQ(result.changed_fields().at(Key("foo/a")),
+            (FieldMask{testutil::Field("x"), testutil::Field("y"),
+                       testutil::Field("z")}));
+}
+
+TEST_P(LocalStoreTest, HandlesAcknowledgingSeveralBatchesAtOnce) {
+  WriteMutation(testutil::SetMutation("foo/bar", Map("foo", "bar")));
+  WriteMutation(testutil::PatchMutation("foo/bar", Map("baz", "qux")));
+  WriteMutation(testutil::SetMutation("foo/baz", Map("foo", "baz")));
+
+  std::vector<MutationBatchResult> results;
+  for (size_t i = 0; i < batches_.size(); ++i) {
+    SnapshotVersion version = testutil::Version(i + 1);
+    results.emplace_back(batches_[i], version,
+                         std::vector<MutationResult>{
+                             MutationResult(version, absl::nullopt)},
+                         ByteString{});
+  }
+  batches_.clear();
+  last_changes_ = local_store_.AcknowledgeBatches(results);
+
+  FSTAssertChanged(Doc("foo/bar", 2, Map("foo", "bar", "baz", "qux"),
+                       DocumentState::kCommittedMutations),
+                   Doc("foo/baz", 3, Map("foo", "baz"),
+                       DocumentState::kCommittedMutations));
+  if (IsGcEager()) {
+    FSTAssertNotContains("foo/bar");
+    FSTAssertNotContains("foo/baz");
+  } else {
+    FSTAssertContains(Doc("foo/bar", 2, Map("foo", "bar", "baz", "qux"),
+                          DocumentState::kCommittedMutations));
+    FSTAssertContains(Doc("foo/baz", 3, Map("foo", "baz"),
+                          DocumentState::kCommittedMutations));
+  }
+}
+
 TEST_P(LocalStoreTest, HandlesSetMutationThenDocument) {
   WriteMutation(testutil::SetMutation("foo/bar", Map("foo", "bar")));
   FSTAssertChanged(
@@ -1338,6 +1388,43 @@ TEST_P(LocalStoreTest, QueriesFilterDocumentsThatNoLongerMatch) {
   FSTAssertQueryReturned("foo/a");
 }
 
+TEST_P(LocalStoreTest, QueriesIncludeDocumentsPatchedToMatch) {
+  if (IsGcEager()) return;
+
+  WriteMutation(testutil::SetMutation("foo/a", Map("matches", false)));
+  AcknowledgeMutationWithVersion(10);
+
+  // Patch the document several times, so that it only matches once all the
+  // patches are applied.
+  WriteMutation(testutil::PatchMutation("foo/a", Map("count", 1)));
+  WriteMutation(testutil::PatchMutation("foo/a", Map("matches", true)));
+  WriteMutation(testutil::PatchMutation("foo/a", Map("count", 2)));
+
+  core::Query query =
+      Query("foo").AddingFilter(testutil::Filter("matches", "==", true));
+  QueryResult query_result = ExecuteQuery(query);
+  ASSERT_EQ(DocMapToVector(query_result.documents()),
+            Vector(Doc("foo/a", 10, Map("matches", true, "count", 2),
+                       DocumentState::kLocalMutations)));
+}
+
+TEST_P(LocalStoreTest, QueriesDoNotReadDocumentsPatchedOnUnfilteredFields) {
+  if (IsGcEager()) return;
+
+  WriteMutation(testutil::SetMutation("foo/a", Map("matches", false)));
+  AcknowledgeMutationWithVersion(10);
+
+  // The patch doesn't touch the filtered field, so it can't make the
+  // document match and the document doesn't need to be read by key.
+  WriteMutation(testutil::PatchMutation("foo/a", Map("count", 1)));
+
+  core::Query query =
+      Query("foo").AddingFilter(testutil::Filter("matches", "==", true));
+  ExecuteQuery(query);
+  FSTAssertQueryReturned();
+  ASSERT_EQ(query_engine_.documents_read_by_key(), 0);
+}
+
 TEST_P(LocalStoreTest,
        HandlesSetMutationThenTransformThenRemoteEventThenTransform) {  // NOLINT
   core::Query query = Query("foo");
@@ -340,6 +340,30 @@ TEST_P(MutationQueueTest, AllMutationBatchesAffectingQuery) {
   });
 }
 
+TEST_P(MutationQueueTest, AllMutationBatchesAffectingQueryAfterRemoval) {
+  persistence_->Run("AllMutationBatchesAffectingQueryAfterRemoval", [&] {
+    MutationBatch batch1 = mutation_queue_->AddMutationBatch(
+        Timestamp::Now(), {},
+        {testutil::SetMutation("foo/bar", Map("a", 1)),
+         testutil::SetMutation("bar/baz", Map("a", 1))});
+    MutationBatch batch2 = mutation_queue_->AddMutationBatch(
+        Timestamp::Now(), {}, {testutil::SetMutation("foo/baz", Map("a", 1))});
+
+    mutation_queue_->RemoveMutationBatch(batch1);
+
+    std::vector<MutationBatch> expected = {batch2};
+    EXPECT_EQ(mutation_queue_->AllMutationBatchesAffectingQuery(Query("foo")),
+              expected);
+    EXPECT_TRUE(mutation_queue_->AllMutationBatchesAffectingQuery(Query("bar"))
+                    .empty());
+
+    mutation_queue_->RemoveMutationBatch(batch2);
+    EXPECT_TRUE(mutation_queue_->AllMutationBatchesAffectingQuery(Query("foo"))
+                    .empty());
+    mutation_queue_->PerformConsistencyCheck();
+  });
+}
+
 TEST_P(MutationQueueTest, RemoveMutationBatches) {
   persistence_->Run("RemoveMutationBatches", [&] {
     std::vector<MutationBatch> batches = CreateBatches(10);
@@ -55,8 +55,10 @@ using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentSet;
 using model::DocumentState;
+using model::FieldPath;
 using model::SnapshotVersion;
 using model::TargetId;
+using testutil::Array;
 using testutil::Doc;
 using testutil::DocSet;
 using testutil::Filter;
@@ -64,6 +66,7 @@ using testutil::Key;
 using testutil::Map;
 using testutil::OrderBy;
 using testutil::Query;
+using testutil::Ref;
 using testutil::Version;
 
 const int kTestTargetId = 1;
@@ -112,6 +115,10 @@ class TestLocalDocumentsView : public LocalDocumentsView {
     expect_full_collection_scan_ = full_collection_scan;
   }
 
+  void ExpectNoCollectionScan() {
+    expect_full_collection_scan_ = absl::nullopt;
+  }
+
  private:
   absl::optional<bool> expect_full_collection_scan_;
 };
@@ -162,6 +169,11 @@ class QueryEngineTest : public ::testing::Test {
     return f();
   }
 
+  DocumentSet ExpectKeyLookup(const std::function<DocumentSet(void)>& f) {
+    local_documents_view_.ExpectNoCollectionScan();
+    return f();
+  }
+
   DocumentSet RunQuery(
       const core::Query& query,
       const SnapshotVersion& last_limbo_free_snapshot_version) {
@@ -384,6 +396,37 @@ TEST_F(QueryEngineTest,
                                         Doc("coll/b", 1, Map("order", 3))}));
 }
 
+TEST_F(QueryEngineTest, UsesKeyLookupForKeyEqualityQuery) {
+  core::Query query = Query("coll").AddingFilter(
+      Filter(FieldPath::kDocumentKeyPath, "==", Ref("project", "coll/a")));
+
+  AddDocuments({kMatchingDocA, kMatchingDocB});
+
+  DocumentSet docs = ExpectKeyLookup(
+      [&] { return RunQuery(query, kMissingLastLimboFreeSnapshot); });
+  EXPECT_EQ(docs, DocSet(query.Comparator(), {kMatchingDocA}));
+}
+
+TEST_F(QueryEngineTest, UsesKeyLookupForKeyInQuery) {
+  core::Query query =
+      Query("coll")
+          .AddingFilter(Filter(FieldPath::kDocumentKeyPath, "in",
+                               Array(Ref("project", "coll/a"),
+                                     Ref("project", "coll/c"),
+                                     Ref("project", "other/b"))))
+          .AddingFilter(Filter("matches", "==", true));
+
+  AddDocuments({kMatchingDocA, kMatchingDocB,
+                Doc("coll/c", 1, Map("matches", false)),
+                Doc("other/b", 1, Map("matches", true))});
+  PersistQueryMapping({kMatchingDocA.key()});
+
+  // The lookup still applies the query's other filters and its path.
+  DocumentSet docs =
+      ExpectKeyLookup([&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+  EXPECT_EQ(docs, DocSet(query.Comparator(), {kMatchingDocA}));
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -17,6 +17,7 @@
 #include "Firestore/core/src/local/reference_set.h"
 
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "gtest/gtest.h"
 
@@ -25,6 +26,7 @@ namespace firestore {
 namespace local {
 
 using model::DocumentKey;
+using model::DocumentKeySet;
 
 TEST(ReferenceSetTest, AddOrRemoveReferences) {
   DocumentKey key = testutil::Key("foo/bar");
@@ -78,6 +80,44 @@ TEST(ReferenceSetTest, RemoteAllReferencesForTargetId) {
   EXPECT_FALSE(reference_set.ContainsKey(key3));
 }
 
+TEST(ReferenceSetTest, CountsDistinctReferences) {
+  DocumentKey key1 = testutil::Key("foo/bar");
+  DocumentKey key2 = testutil::Key("foo/baz");
+  ReferenceSet reference_set{};
+
+  reference_set.AddReference(key1, 1);
+  reference_set.AddReference(key1, 1);
+  reference_set.AddReference(key1, 2);
+  reference_set.AddReference(key2, 2);
+  EXPECT_EQ(reference_set.size(), 3u);
+
+  reference_set.RemoveReference(key1, 1);
+  EXPECT_EQ(reference_set.size(), 2u);
+  EXPECT_TRUE(reference_set.ContainsKey(key1));
+
+  reference_set.RemoveAllReferences();
+  EXPECT_TRUE(reference_set.empty());
+  EXPECT_FALSE(reference_set.ContainsKey(key1));
+  EXPECT_FALSE(reference_set.ContainsKey(key2));
+}
+
+TEST(ReferenceSetTest, ReturnsSnapshotsOfReferencedKeys) {
+  DocumentKey key1 = testutil::Key("foo/bar");
+  DocumentKey key2 = testutil::Key("foo/baz");
+  ReferenceSet reference_set{};
+
+  reference_set.AddReference(key1, 1);
+  reference_set.AddReference(key2, 1);
+  DocumentKeySet referenced = reference_set.ReferencedKeys(1);
+  EXPECT_EQ(referenced, (DocumentKeySet{key1, key2}));
+
+  DocumentKeySet removed = reference_set.RemoveReferences(1);
+  EXPECT_EQ(removed, (DocumentKeySet{key1, key2}));
+  EXPECT_EQ(referenced, (DocumentKeySet{key1, key2}));
+  EXPECT_EQ(reference_set.ReferencedKeys(1), DocumentKeySet{});
+  EXPECT_EQ(reference_set.RemoveReferences(1), DocumentKeySet{});
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -0,0 +1,308 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/document_map.h"
+#include "Firestore/core/src/model/field_value.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_format.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using model::Document;
+using model::DocumentKeySet;
+using model::FieldValue;
+using model::SnapshotVersion;
+using testutil::Array;
+using testutil::Doc;
+using testutil::Map;
+using testutil::Version;
+
+using PersistenceFactory = std::unique_ptr<Persistence> (*)();
+
+const char* kCollection = "docs";
+const char* kCollectionGroup = "messages";
+const int64_t kDocumentsPerParent = 100;
+
+std::unique_ptr<Persistence> MakeMemoryPersistence() {
+  return MemoryPersistenceWithEagerGcForTesting();
+}
+
+std::unique_ptr<Persistence> MakeLevelDbPersistence() {
+  return LevelDbPersistenceForTesting();
+}
+
+/**
+ * Returns a document of roughly 1KB, shaped like typical application data:
+ * mostly short strings, with a few numbers, an array and a nested map.
+ */
+Document MakeDocument(const std::string& path, int64_t index) {
+  FieldValue::Map data = Map(
+      "index", index, "active", index % 2 == 0, "score", index * 0.5, "tags",
+      Array("alpha", "beta", "gamma", "delta"), "address",
+      Map("street", "1600 Amphitheatre Parkway", "city", "Mountain View",
+          "zip", "94043"));
+
+  std::string text(100, 'x');
+  for (int i = 0; i < 8; ++i) {
+    data = data.insert(absl::StrFormat("field%d", i),
+                       FieldValue::FromString(text));
+  }
+
+  return Doc(path, index + 1, data);
+}
+
+Document MakeDocument(int64_t index) {
+  return MakeDocument(absl::StrFormat("%s/doc%08d", kCollection, index), index);
+}
+
+std::vector<Document> MakeDocuments(int64_t count) {
+  std::vector<Document> result;
+  result.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    result.push_back(MakeDocument(i));
+  }
+  return result;
+}
+
+void AddDocuments(Persistence* persistence,
+                  const std::vector<Document>& documents) {
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+  persistence->Run("Add documents", [&] {
+    for (const Document& doc : documents) {
+      cache->Add(doc, doc.version());
+    }
+  });
+}
+
+void BM_RemoteDocumentCacheAdd(benchmark::State& state,
+                               PersistenceFactory factory) {
+  std::vector<Document> documents = MakeDocuments(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<Persistence> persistence = factory();
+    state.ResumeTiming();
+
+    AddDocuments(persistence.get(), documents);
+
+    state.PauseTiming();
+    persistence->Shutdown();
+    persistence.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RemoteDocumentCacheGetAll(benchmark::State& state,
+                                  PersistenceFactory factory) {
+  std::vector<Document> documents = MakeDocuments(state.range(0));
+  std::unique_ptr<Persistence> persistence = factory();
+  AddDocuments(persistence.get(), documents);
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+
+  // Look up every tenth document, so the keys are spread across the cache.
+  DocumentKeySet keys;
+  for (size_t i = 0; i < documents.size(); i += 10) {
+    keys = keys.insert(documents[i].key());
+  }
+
+  for (auto _ : state) {
+    persistence->Run("GetAll", [&] {
+      benchmark::DoNotOptimize(cache->GetAll(keys));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+  persistence->Shutdown();
+}
+
+void BM_RemoteDocumentCacheGetMatching(benchmark::State& state,
+                                       PersistenceFactory factory) {
+  std::vector<Document> documents = MakeDocuments(state.range(0));
+  std::unique_ptr<Persistence> persistence = factory();
+  AddDocuments(persistence.get(), documents);
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+  core::Query query = testutil::Query(kCollection);
+
+  for (auto _ : state) {
+    persistence->Run("GetMatching", [&] {
+      benchmark::DoNotOptimize(
+          cache->GetMatching(query, SnapshotVersion::None()));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * documents.size());
+  persistence->Shutdown();
+}
+
+// Only the most recently read 1% of the documents match, as when a listener
+// resumes a query it executed recently.
+void BM_RemoteDocumentCacheGetMatchingSinceReadTime(
+    benchmark::State& state, PersistenceFactory factory) {
+  std::vector<Document> documents = MakeDocuments(state.range(0));
+  std::unique_ptr<Persistence> persistence = factory();
+  AddDocuments(persistence.get(), documents);
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+  core::Query query = testutil::Query(kCollection);
+
+  int64_t recent = state.range(0) / 100;
+  SnapshotVersion since_read_time = Version(state.range(0) - recent);
+
+  for (auto _ : state) {
+    persistence->Run("GetMatching since read time", [&] {
+      benchmark::DoNotOptimize(cache->GetMatching(query, since_read_time));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * recent);
+  persistence->Shutdown();
+}
+
+/**
+ * Returns `count` documents in the `messages` collection group, spread over
+ * parents with `kDocumentsPerParent` documents each. Every parent also has a
+ * sibling `members` subcollection of the same size, which collection group
+ * queries for `messages` have to skip.
+ */
+std::vector<Document> MakeCollectionGroupDocuments(int64_t count) {
+  std::vector<Document> result;
+  result.reserve(count * 2);
+  for (int64_t i = 0; i < count; ++i) {
+    int64_t parent = i / kDocumentsPerParent;
+    result.push_back(MakeDocument(
+        absl::StrFormat("rooms/room%06d/%s/doc%08d", parent, kCollectionGroup,
+                        i),
+        i));
+    result.push_back(MakeDocument(
+        absl::StrFormat("rooms/room%06d/members/doc%08d", parent, i), i));
+  }
+  return result;
+}
+
+// Answers a collection group query from the collection group index.
+void BM_RemoteDocumentCacheGetMatchingCollectionGroup(
+    benchmark::State& state, PersistenceFactory factory) {
+  std::unique_ptr<Persistence> persistence = factory();
+  AddDocuments(persistence.get(), MakeCollectionGroupDocuments(state.range(0)));
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+  core::Query query = testutil::CollectionGroupQuery(kCollectionGroup);
+
+  for (auto _ : state) {
+    persistence->Run("GetMatching collection group", [&] {
+      benchmark::DoNotOptimize(
+          cache->GetMatching(query, SnapshotVersion::None()));
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  persistence->Shutdown();
+}
+
+// Answers the same collection group query as above with one collection query
+// per parent and merges their results, as was done before the collection
+// group index existed. This is the baseline for
+// BM_RemoteDocumentCacheGetMatchingCollectionGroup.
+void BM_RemoteDocumentCacheGetMatchingCollectionsByParent(
+    benchmark::State& state, PersistenceFactory factory) {
+  std::unique_ptr<Persistence> persistence = factory();
+  AddDocuments(persistence.get(), MakeCollectionGroupDocuments(state.range(0)));
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+
+  int64_t parents =
+      (state.range(0) + kDocumentsPerParent - 1) / kDocumentsPerParent;
+  std::vector<core::Query> queries;
+  queries.reserve(parents);
+  for (int64_t i = 0; i < parents; ++i) {
+    queries.push_back(testutil::Query(
+        absl::StrFormat("rooms/room%06d/%s", i, kCollectionGroup)));
+  }
+
+  for (auto _ : state) {
+    persistence->Run("GetMatching collections by parent", [&] {
+      model::DocumentMap results;
+      for (const core::Query& query : queries) {
+        model::DocumentMap collection_results =
+            cache->GetMatching(query, SnapshotVersion::None());
+        for (const auto& kv : collection_results.underlying_map()) {
+          results = results.insert(kv.first, Document(kv.second));
+        }
+      }
+      benchmark::DoNotOptimize(results);
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  persistence->Shutdown();
+}
+
+void BM_RemoteDocumentCacheRemove(benchmark::State& state,
+                                  PersistenceFactory factory) {
+  std::vector<Document> documents = MakeDocuments(state.range(0));
+  std::unique_ptr<Persistence> persistence = factory();
+  RemoteDocumentCache* cache = persistence->remote_document_cache();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    AddDocuments(persistence.get(), documents);
+    state.ResumeTiming();
+
+    persistence->Run("Remove documents", [&] {
+      for (const Document& doc : documents) {
+        cache->Remove(doc.key());
+      }
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * documents.size());
+  persistence->Shutdown();
+}
+
+#define REMOTE_DOCUMENT_CACHE_BENCHMARK(name)                   \
+  BENCHMARK_CAPTURE(name, Memory, MakeMemoryPersistence)        \
+      ->Arg(1000)                                               \
+      ->Arg(10000)                                              \
+      ->Arg(100000)                                             \
+      ->Unit(benchmark::kMillisecond);                          \
+  BENCHMARK_CAPTURE(name, LevelDb, MakeLevelDbPersistence)      \
+      ->Arg(1000)                                               \
+      ->Arg(10000)                                              \
+      ->Arg(100000)                                             \
+      ->Unit(benchmark::kMillisecond)
+
+REMOTE_DOCUMENT_CACHE_BENCHMARK(BM_RemoteDocumentCacheAdd);
+REMOTE_DOCUMENT_CACHE_BENCHMARK(BM_RemoteDocumentCacheGetAll);
+REMOTE_DOCUMENT_CACHE_BENCHMARK(BM_RemoteDocumentCacheGetMatching);
+REMOTE_DOCUMENT_CACHE_BENCHMARK(BM_RemoteDocumentCacheGetMatchingSinceReadTime);
+REMOTE_DOCUMENT_CACHE_BENCHMARK(
+    BM_RemoteDocumentCacheGetMatchingCollectionGroup);
+REMOTE_DOCUMENT_CACHE_BENCHMARK(
+    BM_RemoteDocumentCacheGetMatchingCollectionsByParent);
+REMOTE_DOCUMENT_CACHE_BENCHMARK(BM_RemoteDocumentCacheRemove);
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
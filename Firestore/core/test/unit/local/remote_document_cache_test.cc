@@ -17,6 +17,7 @@
 #include "Firestore/core/test/unit/local/remote_document_cache_test.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "Firestore/core/src/core/query.h"
@@ -147,6 +148,35 @@ TEST_P(RemoteDocumentCacheTest,
       });
 }
 
+TEST_P(RemoteDocumentCacheTest, ReadManyDocumentsIncludingMissingDocuments) {
+  persistence_->Run(
+      "test_read_many_documents_including_missing_documents", [=] {
+        // Cover both a request that spans most of the cache and one that only
+        // touches a few of its documents.
+        DocumentKeySet all_keys;
+        DocumentKeySet some_keys;
+        for (int i = 0; i < 60; ++i) {
+          std::string path = "a/" + std::to_string(100 + i);
+          if (i % 3 != 0) {
+            SetTestDocument(path);
+          }
+          all_keys = all_keys.insert(testutil::Key(path));
+          if (i % 20 == 1 || i % 20 == 3) {
+            some_keys = some_keys.insert(testutil::Key(path));
+          }
+        }
+
+        for (const DocumentKeySet& keys : {all_keys, some_keys}) {
+          OptionalMaybeDocumentMap read = cache_->GetAll(keys);
+          ASSERT_EQ(keys.size(), read.size());
+          for (const auto& kv : read) {
+            ASSERT_TRUE(keys.contains(kv.first));
+            ASSERT_EQ(cache_->Get(kv.first), kv.second);
+          }
+        }
+      });
+}
+
 TEST_P(RemoteDocumentCacheTest, SetAndReadADocumentAtDeepPath) {
   SetAndReadTestDocument(kLongDocPath);
 }
@@ -223,6 +253,28 @@ TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQuerySinceReadTime) {
   });
 }
 
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQueryAfterUpdates) {
+  persistence_->Run("test_documents_matching_query_after_updates", [&] {
+    SetTestDocument("b/reread", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("b/deleted", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("b/removed", /* updateTime= */ 1, /* readTime= */ 11);
+
+    SetTestDocument("b/reread", /* updateTime= */ 1, /* readTime= */ 13);
+    cache_->Add(DeletedDoc("b/deleted", 2), Version(13));
+    cache_->Remove(testutil::Key("b/removed"));
+
+    core::Query query = Query("b");
+    std::vector<Document> docs = {
+        Doc("b/reread", 1, kDocData),
+    };
+    EXPECT_THAT(cache_->GetMatching(query, Version(12)).underlying_map(),
+                HasExactlyDocs(docs));
+    EXPECT_THAT(
+        cache_->GetMatching(query, SnapshotVersion::None()).underlying_map(),
+        HasExactlyDocs(docs));
+  });
+}
+
 TEST_P(RemoteDocumentCacheTest, DocumentsMatchingUsesReadTimeNotUpdateTime) {
   persistence_->Run(
       "test_documents_matching_query_uses_read_time_not_update_time", [&] {
@@ -238,6 +290,62 @@ TEST_P(RemoteDocumentCacheTest, DocumentsMatchingUsesReadTimeNotUpdateTime) {
       });
 }
 
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingCollectionGroupQuery) {
+  persistence_->Run("test_documents_matching_collection_group_query", [&] {
+    SetTestDocument("a/1");
+    SetTestDocument("a/1/b/1");
+    SetTestDocument("a/2/b/2");
+    SetTestDocument("b/3");
+    SetTestDocument("b/3/c/4");
+    SetTestDocument("bb/5");
+    SetTestDocument("c/6/b/7/d/8");
+    SetTestDocument("c/6/b/7/b/9");
+
+    core::Query query = testutil::CollectionGroupQuery("b");
+    DocumentMap results = cache_->GetMatching(query, SnapshotVersion::None());
+    std::vector<Document> docs = {
+        Doc("a/1/b/1", kVersion, kDocData),
+        Doc("a/2/b/2", kVersion, kDocData),
+        Doc("b/3", kVersion, kDocData),
+        Doc("c/6/b/7/b/9", kVersion, kDocData),
+    };
+    EXPECT_THAT(results.underlying_map(), HasExactlyDocs(docs));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest,
+       DocumentsMatchingCollectionGroupQuerySinceReadTime) {
+  persistence_->Run(
+      "test_documents_matching_collection_group_query_since_read_time", [&] {
+        SetTestDocument("a/1/b/old", /* updateTime= */ 1, /* readTime= */ 11);
+        SetTestDocument("a/2/b/current", /* updateTime= */ 2,
+                        /* readTime= */ 12);
+        SetTestDocument("b/new", /* updateTime= */ 3, /* readTime= */ 13);
+
+        core::Query query = testutil::CollectionGroupQuery("b");
+        DocumentMap results = cache_->GetMatching(query, Version(12));
+        std::vector<Document> docs = {
+            Doc("b/new", 3, kDocData),
+        };
+        EXPECT_THAT(results.underlying_map(), HasExactlyDocs(docs));
+      });
+}
+
+TEST_P(RemoteDocumentCacheTest, RemovedDocumentsDontMatchCollectionGroupQuery) {
+  persistence_->Run("test_removed_documents_dont_match_collection_group", [&] {
+    SetTestDocument("a/1/b/1");
+    SetTestDocument("a/2/b/2");
+    cache_->Remove(testutil::Key("a/1/b/1"));
+
+    core::Query query = testutil::CollectionGroupQuery("b");
+    DocumentMap results = cache_->GetMatching(query, SnapshotVersion::None());
+    std::vector<Document> docs = {
+        Doc("a/2/b/2", kVersion, kDocData),
+    };
+    EXPECT_THAT(results.underlying_map(), HasExactlyDocs(docs));
+  });
+}
+
 // MARK: - Helpers
 
 Document RemoteDocumentCacheTest::SetTestDocument(const absl::string_view path,
@@ -18,6 +18,7 @@
 
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "Firestore/core/src/core/field_filter.h"
@@ -245,6 +246,32 @@ TEST_P(TargetCacheTest, RemoveTargets) {
   });
 }
 
+TEST_P(TargetCacheTest, RemoveTargetsSkipsLiveAndRecentlyUpdatedTargets) {
+  persistence_->Run("test_remove_targets_skips_live_and_updated", [&] {
+    TargetData target_data1 = MakeTargetData(testutil::Query("a"));
+    cache_->AddTarget(target_data1);
+    TargetData target_data2 = MakeTargetData(testutil::Query("b"));
+    cache_->AddTarget(target_data2);
+    TargetData target_data3 = MakeTargetData(testutil::Query("c"));
+    cache_->AddTarget(target_data3);
+
+    // Move the first target past the upper bound.
+    TargetData updated1 =
+        target_data1.WithSequenceNumber(target_data3.sequence_number() + 1);
+    cache_->UpdateTarget(updated1);
+
+    std::unordered_map<TargetId, TargetData> live_targets{
+        {target_data2.target_id(), target_data2}};
+    size_t removed =
+        cache_->RemoveTargets(target_data3.sequence_number(), live_targets);
+    ASSERT_EQ(removed, 1u);
+
+    ASSERT_EQ(cache_->GetTarget(target_data1.target()), updated1);
+    ASSERT_EQ(cache_->GetTarget(target_data2.target()), target_data2);
+    ASSERT_EQ(cache_->GetTarget(target_data3.target()), absl::nullopt);
+  });
+}
+
 TEST_P(TargetCacheTest, RemoveTargetsRemovesMatchingKeysToo) {
   persistence_->Run("test_remove_targets_removes_matching_keys_too", [&] {
     TargetData rooms = MakeTargetData(query_rooms_);
@@ -65,6 +65,10 @@ TEST(DocumentTest, ExtractsFields) {
   EXPECT_EQ(doc.field(Field("desc")),
             Value("Discuss all the project related stuff"));
   EXPECT_EQ(doc.field(Field("owner.title")), Value("scallywag"));
+
+  ASSERT_NE(doc.FindField(Field("owner.title")), nullptr);
+  EXPECT_EQ(*doc.FindField(Field("owner.title")), Value("scallywag"));
+  EXPECT_EQ(doc.FindField(Field("owner.missing")), nullptr);
 }
 
 TEST(DocumentTest, Equality) {
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/model/field_path.h"
+
+#include <string>
+
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+// Returns a dotted path with the given number of segments.
+std::string DottedPath(int64_t segments, bool escaped) {
+  std::string result;
+  for (int64_t i = 0; i < segments; ++i) {
+    if (i > 0) result += '.';
+    absl::StrAppend(&result, escaped ? "`field " : "field", i,
+                    escaped ? "`" : "");
+  }
+  return result;
+}
+
+void BM_FieldPathFromServerFormat(benchmark::State& state) {
+  std::string path = DottedPath(state.range(0), false);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FieldPath::FromServerFormat(path));
+  }
+}
+BENCHMARK(BM_FieldPathFromServerFormat)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_FieldPathFromServerFormatEscaped(benchmark::State& state) {
+  std::string path = DottedPath(state.range(0), true);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FieldPath::FromServerFormat(path));
+  }
+}
+BENCHMARK(BM_FieldPathFromServerFormatEscaped)->Arg(1)->Arg(4)->Arg(16);
+
+// Field names as parsed by the public API on every write and query.
+void BM_FieldPathFromDotSeparatedString(benchmark::State& state) {
+  std::string path = DottedPath(state.range(0), false);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FieldPath::FromDotSeparatedString(path));
+  }
+}
+BENCHMARK(BM_FieldPathFromDotSeparatedString)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_FieldPathCanonicalString(benchmark::State& state) {
+  FieldPath path =
+      FieldPath::FromServerFormat(DottedPath(state.range(0), true))
+          .ValueOrDie();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(path.CanonicalString());
+  }
+}
+BENCHMARK(BM_FieldPathCanonicalString)->Arg(1)->Arg(4)->Arg(16);
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -267,6 +267,16 @@ TEST(FieldPath, CanonicalStringEscaping) {
   EXPECT_EQ(Parse("a_").CanonicalString(), "a_");
 }
 
+TEST(FieldPath, ParseDotSeparatedString) {
+  const auto path = FieldPath::FromDotSeparatedString("foo.bar baz");
+  EXPECT_EQ(path, (FieldPath{"foo", "bar baz"}));
+  EXPECT_EQ(path.CanonicalString(), "foo.`bar baz`");
+
+  EXPECT_ANY_THROW(FieldPath::FromDotSeparatedString("foo..bar"));
+  EXPECT_ANY_THROW(FieldPath::FromDotSeparatedString("foo/bar"));
+  EXPECT_ANY_THROW(FieldPath::FromDotSeparatedString(""));
+}
+
 TEST(FieldPath, EmptyPath) {
   const auto& empty_path = FieldPath::EmptyPath();
   EXPECT_EQ(empty_path, FieldPath{empty_path});
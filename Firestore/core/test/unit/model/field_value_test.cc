@@ -124,6 +124,25 @@ TEST_F(FieldValueTest, ExtractsFields) {
   EXPECT_EQ(nullopt, value.Get(Field("bar.a")));
 }
 
+TEST_F(FieldValueTest, FindsFields) {
+  ObjectValue value = WrapObject("foo", Map("a", 1, "b", true, "c", "string"));
+
+  ASSERT_NE(nullptr, value.Find(Field("foo")));
+  ASSERT_EQ(Type::Object, value.Find(Field("foo"))->type());
+
+  EXPECT_EQ(Value(1), *value.Find(Field("foo.a")));
+  EXPECT_EQ(Value(true), *value.Find(Field("foo.b")));
+  EXPECT_EQ(Value("string"), *value.Find(Field("foo.c")));
+
+  // Finding a field returns a pointer into the value without copying it.
+  EXPECT_EQ(value.Find(Field("foo.a")), value.Find(Field("foo.a")));
+  EXPECT_EQ(&value.AsFieldValue(), value.Find(FieldPath::EmptyPath()));
+
+  EXPECT_EQ(nullptr, value.Find(Field("foo.a.b")));
+  EXPECT_EQ(nullptr, value.Find(Field("bar")));
+  EXPECT_EQ(nullptr, value.Find(Field("bar.a")));
+}
+
 TEST_F(FieldValueTest, ExtractsFieldMask) {
   ObjectValue value =
       WrapObject("a", "b", "map",
@@ -285,7 +304,8 @@ TEST_F(FieldValueTest, Equality) {
                         Value(kTimestamp2))
       // NOTE: ServerTimestampValues can't be parsed via Value().
       .AddEqualityGroup(FieldValue::FromServerTimestamp(kTimestamp1),
-                        FieldValue::FromServerTimestamp(kTimestamp1))
+                        FieldValue::FromServerTimestamp(kTimestamp1),
+                        FromServerTimestamp(kTimestamp1, Value(1)))
       .AddEqualityGroup(FieldValue::FromServerTimestamp(kTimestamp2))
       .AddEqualityGroup(Value(GeoPoint(0, 1)),
                         FieldValue::FromGeoPoint(GeoPoint(0, 1)))
@@ -307,6 +327,42 @@ TEST_F(FieldValueTest, Equality) {
       .TestEquals();
 }
 
+TEST_F(FieldValueTest, ModifiedCopiesCompareByContent) {
+  ObjectValue old = WrapObject("a", Map("b", Array(1, 2), "c", "old"), "d",
+                               Map("e", Value(std::nan("1"))));
+  ObjectValue mod = old.Set(Field("a.c"), Value("mod"));
+  ObjectValue restored = mod.Set(Field("a.c"), Value("old"));
+
+  EXPECT_NE(old, mod);
+  EXPECT_EQ(old, restored);
+  EXPECT_NE(old.AsFieldValue(), mod.AsFieldValue());
+  EXPECT_EQ(old.AsFieldValue(), restored.AsFieldValue());
+
+  // The unchanged subtree is shared and still compares equal, NaN included.
+  EXPECT_EQ(*old.Find(Field("d")), *mod.Find(Field("d")));
+  EXPECT_EQ(*old.Find(Field("a.b")), *mod.Find(Field("a.b")));
+}
+
+TEST_F(FieldValueTest, CachedHashesAreConsistentWithEquality) {
+  FieldValue lhs = WrapObject("a", Array(1, Map("b", 2)), "c", "d");
+  FieldValue same = WrapObject("c", "d", "a", Array(1, Map("b", 2)));
+  FieldValue different = WrapObject("a", Array(1, Map("b", 3)), "c", "d");
+
+  // Equality must not depend on whether hashes have been computed yet.
+  EXPECT_EQ(lhs, same);
+  EXPECT_NE(lhs, different);
+
+  size_t hash = lhs.Hash();
+  EXPECT_EQ(hash, lhs.Hash());
+  EXPECT_EQ(hash, same.Hash());
+  EXPECT_NE(hash, different.Hash());
+
+  EXPECT_EQ(lhs, same);
+  EXPECT_NE(lhs, different);
+  EXPECT_TRUE(util::Same(lhs.CompareTo(same)));
+  EXPECT_FALSE(util::Same(lhs.CompareTo(different)));
+}
+
 #if __APPLE__
 // Validates that NSNumber/CFNumber normalize NaNs to the same values that
 // Firestore does. This uses CoreFoundation's CFNumber instead of NSNumber just
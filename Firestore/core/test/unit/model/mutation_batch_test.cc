@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/model/mutation_batch.h"
+
+#include <vector>
+
+#include "Firestore/core/src/model/delete_mutation.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/document_map.h"
+#include "Firestore/core/src/model/maybe_document.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/patch_mutation.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace model {
+namespace {
+
+using testutil::DeleteMutation;
+using testutil::Doc;
+using testutil::Increment;
+using testutil::Key;
+using testutil::Map;
+using testutil::MutationResult;
+using testutil::PatchMutation;
+using testutil::SetMutation;
+using testutil::Value;
+using testutil::Version;
+
+const Timestamp now = Timestamp::Now();
+
+TEST(MutationBatchTest, AppliesMutationsOfTheDocumentInOrder) {
+  MutationBatch batch(1, now, {},
+                      {SetMutation("coll/a", Map("foo", "bar")),
+                       SetMutation("coll/b", Map("baz", 1)),
+                       PatchMutation("coll/a", Map("qux", 2))});
+
+  absl::optional<MaybeDocument> result =
+      batch.ApplyToLocalDocument(absl::nullopt, Key("coll/a"));
+
+  EXPECT_EQ(result, Doc("coll/a", 0, Map("foo", "bar", "qux", 2),
+                        DocumentState::kLocalMutations));
+}
+
+TEST(MutationBatchTest, LeavesDocumentsNotInTheBatchUnchanged) {
+  MutationBatch batch(1, now, {}, {SetMutation("coll/a", Map("foo", "bar"))});
+  Document doc = Doc("coll/b", 1, Map("baz", 1));
+
+  EXPECT_EQ(batch.ApplyToLocalDocument(doc, doc.key()), doc);
+  EXPECT_EQ(batch.ApplyToLocalDocument(absl::nullopt, Key("coll/b")),
+            absl::nullopt);
+}
+
+TEST(MutationBatchTest, AppliesBaseMutationsBeforeMutations) {
+  MutationBatch batch(1, now, {SetMutation("coll/a", Map("sum", 1))},
+                      {PatchMutation("coll/a", Map(),
+                                     {Increment("sum", Value(2))})});
+
+  absl::optional<MaybeDocument> result =
+      batch.ApplyToLocalDocument(absl::nullopt, Key("coll/a"));
+
+  EXPECT_EQ(result,
+            Doc("coll/a", 0, Map("sum", 3), DocumentState::kLocalMutations));
+}
+
+TEST(MutationBatchTest, AppliesToLocalDocumentSetOncePerDocument) {
+  MutationBatch batch(
+      1, now, {},
+      {PatchMutation("coll/a", Map(), {Increment("sum", Value(1))}),
+       PatchMutation("coll/a", Map(), {Increment("sum", Value(1))}),
+       DeleteMutation("coll/b")});
+
+  MaybeDocumentMap documents;
+  documents = documents.insert(Key("coll/a"), Doc("coll/a", 1, Map("sum", 0)));
+  documents = documents.insert(Key("coll/b"), Doc("coll/b", 1, Map()));
+  documents = documents.insert(Key("coll/c"), Doc("coll/c", 1, Map()));
+
+  MaybeDocumentMap result = batch.ApplyToLocalDocumentSet(documents);
+
+  EXPECT_EQ(result.size(), 3);
+  EXPECT_EQ(result.get(Key("coll/a")),
+            Doc("coll/a", 1, Map("sum", 2), DocumentState::kLocalMutations));
+  EXPECT_TRUE(result.get(Key("coll/b"))->is_no_document());
+  EXPECT_EQ(result.get(Key("coll/c")), Doc("coll/c", 1, Map()));
+}
+
+TEST(MutationBatchTest, AppliesResultsOfTheDocumentToRemoteDocument) {
+  MutationBatch batch(1, now, {},
+                      {SetMutation("coll/a", Map("foo", "bar")),
+                       SetMutation("coll/b", Map("baz", 1)),
+                       PatchMutation("coll/a", Map("qux", 2))});
+  MutationBatchResult batch_result(
+      batch, Version(5),
+      {MutationResult(3), MutationResult(4), MutationResult(5)}, {});
+
+  absl::optional<MaybeDocument> result = batch.ApplyToRemoteDocument(
+      absl::nullopt, Key("coll/a"), batch_result);
+
+  EXPECT_EQ(result, Doc("coll/a", 5, Map("foo", "bar", "qux", 2),
+                        DocumentState::kCommittedMutations));
+}
+
+TEST(MutationBatchTest, CopiesApplyLikeTheOriginal) {
+  MutationBatch batch(1, now, {},
+                      {SetMutation("coll/a", Map("foo", "bar")),
+                       SetMutation("coll/b", Map("baz", 1))});
+  MutationBatch copy = batch;
+
+  EXPECT_EQ(copy, batch);
+  EXPECT_EQ(copy.ApplyToLocalDocument(absl::nullopt, Key("coll/b")),
+            Doc("coll/b", 0, Map("baz", 1), DocumentState::kLocalMutations));
+  EXPECT_EQ(copy.keys(), DocumentKeySet({Key("coll/a"), Key("coll/b")}));
+}
+
+}  // namespace
+}  // namespace model
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/test/unit/remote/fake_datastore.h"
+
+#include <queue>
+#include <utility>
+
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/model/snapshot_version.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/remote/write_stream.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+using auth::CredentialsProvider;
+using model::Mutation;
+using model::MutationResult;
+using model::SnapshotVersion;
+using util::AsyncQueue;
+using util::Status;
+
+class FakeWriteStream : public WriteStream {
+ public:
+  FakeWriteStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                  std::shared_ptr<CredentialsProvider> credentials_provider,
+                  Serializer serializer,
+                  GrpcConnection* grpc_connection,
+                  WriteStreamCallback* callback)
+      : WriteStream{worker_queue, std::move(credentials_provider),
+                    std::move(serializer), grpc_connection, callback},
+        callback_{callback} {
+  }
+
+  void Start() override {
+    HARD_ASSERT(!open_, "Trying to start already started write stream");
+    open_ = true;
+    sent_mutations_ = {};
+    callback_->OnWriteStreamOpen();
+  }
+
+  void Stop() override {
+    WriteStream::Stop();
+
+    sent_mutations_ = {};
+    open_ = false;
+    SetHandshakeComplete(false);
+  }
+
+  bool IsStarted() const override {
+    return open_;
+  }
+  bool IsOpen() const override {
+    return open_;
+  }
+
+  void WriteHandshake() override {
+    SetHandshakeComplete();
+    callback_->OnWriteStreamHandshakeComplete();
+  }
+
+  void WriteMutations(const std::vector<Mutation>& mutations) override {
+    sent_mutations_.push(mutations);
+  }
+
+  void AckWrite(const SnapshotVersion& commit_version,
+                std::vector<MutationResult> results) {
+    callback_->OnWriteStreamMutationResult(commit_version, std::move(results));
+  }
+
+  void FailStream(const Status& error) {
+    open_ = false;
+    callback_->OnWriteStreamClose(error);
+  }
+
+  std::vector<Mutation> NextSentWrite() {
+    HARD_ASSERT(!sent_mutations_.empty(),
+                "Writes need to happen before you can call NextSentWrite.");
+    std::vector<Mutation> result = std::move(sent_mutations_.front());
+    sent_mutations_.pop();
+    return result;
+  }
+
+  int sent_mutations_count() const {
+    return static_cast<int>(sent_mutations_.size());
+  }
+
+ private:
+  bool open_ = false;
+  std::queue<std::vector<Mutation>> sent_mutations_;
+  WriteStreamCallback* callback_ = nullptr;
+};
+
+FakeDatastore::FakeDatastore(
+    const core::DatabaseInfo& database_info,
+    const std::shared_ptr<AsyncQueue>& worker_queue,
+    std::shared_ptr<CredentialsProvider> credentials,
+    ConnectivityMonitor* connectivity_monitor,
+    FirebaseMetadataProvider* firebase_metadata_provider)
+    : Datastore{database_info, worker_queue, credentials, connectivity_monitor,
+                firebase_metadata_provider},
+      database_info_{&database_info},
+      worker_queue_{worker_queue},
+      credentials_{std::move(credentials)} {
+}
+
+std::shared_ptr<WriteStream> FakeDatastore::CreateWriteStream(
+    WriteStreamCallback* callback) {
+  write_stream_ = std::make_shared<FakeWriteStream>(
+      worker_queue_, credentials_, Serializer{database_info_->database_id()},
+      grpc_connection(), callback);
+  return write_stream_;
+}
+
+bool FakeDatastore::IsWriteStreamOpen() const {
+  return write_stream_->IsOpen();
+}
+
+std::vector<Mutation> FakeDatastore::NextSentWrite() {
+  return write_stream_->NextSentWrite();
+}
+
+int FakeDatastore::WritesSent() const {
+  return write_stream_->sent_mutations_count();
+}
+
+void FakeDatastore::AckWrite(const SnapshotVersion& version,
+                             std::vector<MutationResult> results) {
+  write_stream_->AckWrite(version, std::move(results));
+}
+
+void FakeDatastore::FailWrite(const Status& error) {
+  write_stream_->FailStream(error);
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_TEST_UNIT_REMOTE_FAKE_DATASTORE_H_
+#define FIRESTORE_CORE_TEST_UNIT_REMOTE_FAKE_DATASTORE_H_
+
+#include <memory>
+#include <vector>
+
+#include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/util/status_fwd.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+class FakeWriteStream;
+
+/**
+ * A `Datastore` whose write stream never touches the network: writes sent by
+ * the `RemoteStore` are recorded, and acknowledgements and errors are injected
+ * by the test as though they had come from the backend.
+ *
+ * The watch stream is the regular one, so tests using this class must not
+ * listen to any targets while the network is enabled.
+ */
+class FakeDatastore : public Datastore {
+ public:
+  FakeDatastore(const core::DatabaseInfo& database_info,
+                const std::shared_ptr<util::AsyncQueue>& worker_queue,
+                std::shared_ptr<auth::CredentialsProvider> credentials,
+                ConnectivityMonitor* connectivity_monitor,
+                FirebaseMetadataProvider* firebase_metadata_provider);
+
+  std::shared_ptr<WriteStream> CreateWriteStream(
+      WriteStreamCallback* callback) override;
+
+  /** Returns true if the write stream has been started and not closed. */
+  bool IsWriteStreamOpen() const;
+
+  /**
+   * Returns the mutations of the next write that was "sent to the backend",
+   * failing if there are none.
+   */
+  std::vector<model::Mutation> NextSentWrite();
+
+  /**
+   * Returns the number of writes that have been sent to the backend but not
+   * retrieved via `NextSentWrite` yet.
+   */
+  int WritesSent() const;
+
+  /**
+   * Injects a write acknowledgement as though it had come from the backend in
+   * response to the oldest unacknowledged write.
+   */
+  void AckWrite(const model::SnapshotVersion& version,
+                std::vector<model::MutationResult> results);
+
+  /** Injects a stream failure as though it had come from the backend. */
+  void FailWrite(const util::Status& error);
+
+ private:
+  const core::DatabaseInfo* database_info_ = nullptr;
+  std::shared_ptr<util::AsyncQueue> worker_queue_;
+  std::shared_ptr<auth::CredentialsProvider> credentials_;
+
+  std::shared_ptr<FakeWriteStream> write_stream_;
+};
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_TEST_UNIT_REMOTE_FAKE_DATASTORE_H_
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/remote_store.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/auth/empty_credentials_provider.h"
+#include "Firestore/core/src/auth/user.h"
+#include "Firestore/core/src/core/database_info.h"
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/local_write_result.h"
+#include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/mutation_batch_result.h"
+#include "Firestore/core/src/model/set_mutation.h"
+#include "Firestore/core/src/remote/connectivity_monitor.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider.h"
+#include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/fake_datastore.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using auth::EmptyCredentialsProvider;
+using auth::User;
+using local::LocalStore;
+using local::Persistence;
+using local::QueryEngine;
+using model::BatchId;
+using model::DatabaseId;
+using model::DocumentKeySet;
+using model::MutationBatchResult;
+using model::OnlineState;
+using model::TargetId;
+using testutil::Map;
+using testutil::SetMutation;
+using util::AsyncQueue;
+using util::Status;
+using util::TimerId;
+
+/**
+ * Tests of how the `RemoteStore` hands write acknowledgements to the sync
+ * engine. The test fixture stands in for the sync engine, recording the
+ * acknowledgements and rejections it receives.
+ */
+class RemoteStoreTest : public testing::Test, public RemoteStoreCallback {
+ public:
+  RemoteStoreTest()
+      : worker_queue_(testutil::AsyncQueueForTesting()),
+        persistence_(local::MemoryPersistenceWithEagerGcForTesting()),
+        local_store_(persistence_.get(), &query_engine_,
+                     User::Unauthenticated()),
+        database_info_(DatabaseId("p", "d"), "", "localhost", false),
+        connectivity_monitor_(CreateNoOpConnectivityMonitor()),
+        firebase_metadata_provider_(CreateFirebaseMetadataProviderNoOp()),
+        datastore_(std::make_shared<FakeDatastore>(
+            database_info_, worker_queue_,
+            std::make_shared<EmptyCredentialsProvider>(),
+            connectivity_monitor_.get(), firebase_metadata_provider_.get())),
+        remote_store_(&local_store_, datastore_, worker_queue_,
+                      connectivity_monitor_.get(), [](OnlineState) {}) {
+    worker_queue_->EnqueueBlocking([&] {
+      local_store_.Start();
+      remote_store_.set_sync_engine(this);
+    });
+  }
+
+  ~RemoteStoreTest() override {
+    worker_queue_->EnqueueBlocking([&] { remote_store_.Shutdown(); });
+  }
+
+  // Implements `RemoteStoreCallback`.
+  void ApplyRemoteEvent(const RemoteEvent&) override {
+  }
+  void HandleRejectedListen(TargetId, Status) override {
+  }
+  void HandleSuccessfulWrites(
+      const std::vector<MutationBatchResult>& batch_results) override {
+    std::vector<BatchId> batch_ids;
+    for (const MutationBatchResult& batch_result : batch_results) {
+      batch_ids.push_back(batch_result.batch().batch_id());
+    }
+    events_.push_back(Acknowledged(batch_ids));
+    local_store_.AcknowledgeBatches(batch_results);
+  }
+  void HandleRejectedWrite(BatchId batch_id, Status) override {
+    events_.push_back(Rejected(batch_id));
+    local_store_.RejectBatch(batch_id);
+  }
+  void HandleOnlineStateChange(OnlineState) override {
+  }
+  DocumentKeySet GetRemoteKeys(TargetId) const override {
+    return DocumentKeySet{};
+  }
+
+ protected:
+  static std::string Acknowledged(const std::vector<BatchId>& batch_ids) {
+    std::string result = "acknowledged";
+    for (BatchId batch_id : batch_ids) {
+      absl::StrAppend(&result, " ", batch_id);
+    }
+    return result;
+  }
+
+  static std::string Rejected(BatchId batch_id) {
+    return absl::StrCat("rejected ", batch_id);
+  }
+
+  BatchId WriteLocally(const std::string& path) {
+    BatchId batch_id = 0;
+    worker_queue_->EnqueueBlocking([&] {
+      local::LocalWriteResult result =
+          local_store_.WriteLocally({SetMutation(path, Map("a", 1))});
+      batch_id = result.batch_id();
+    });
+    return batch_id;
+  }
+
+  void AckWrite(int64_t version) {
+    worker_queue_->EnqueueBlocking([&] {
+      datastore_->AckWrite(testutil::Version(version),
+                           {testutil::MutationResult(version)});
+    });
+  }
+
+  bool ApplyIsScheduled() const {
+    return worker_queue_->IsScheduled(TimerId::ApplyWriteResults);
+  }
+
+  /** Runs the operation the remote store scheduled to apply results. */
+  void RunScheduledApply() {
+    worker_queue_->RunScheduledOperationsUntil(TimerId::ApplyWriteResults);
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue_;
+  std::unique_ptr<Persistence> persistence_;
+  QueryEngine query_engine_;
+  LocalStore local_store_;
+  core::DatabaseInfo database_info_;
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor_;
+  std::unique_ptr<FirebaseMetadataProvider> firebase_metadata_provider_;
+  std::shared_ptr<FakeDatastore> datastore_;
+  RemoteStore remote_store_;
+
+  std::vector<std::string> events_;
+};
+
+TEST_F(RemoteStoreTest, AppliesAcknowledgementsReceivedTogetherAsOneGroup) {
+  BatchId first = WriteLocally("coll/a");
+  BatchId second = WriteLocally("coll/b");
+  BatchId third = WriteLocally("coll/c");
+  worker_queue_->EnqueueBlocking([&] { remote_store_.EnableNetwork(); });
+  EXPECT_EQ(datastore_->WritesSent(), 3);
+
+  AckWrite(1);
+  AckWrite(2);
+  EXPECT_TRUE(events_.empty());
+  EXPECT_TRUE(ApplyIsScheduled());
+
+  RunScheduledApply();
+  EXPECT_EQ(events_, std::vector<std::string>{Acknowledged({first, second})});
+
+  AckWrite(3);
+  RunScheduledApply();
+  EXPECT_EQ(events_,
+            (std::vector<std::string>{Acknowledged({first, second}),
+                                      Acknowledged({third})}));
+}
+
+TEST_F(RemoteStoreTest, AppliesAcknowledgementsBeforeHandlingWriteErrors) {
+  BatchId first = WriteLocally("coll/a");
+  BatchId second = WriteLocally("coll/b");
+  worker_queue_->EnqueueBlocking([&] { remote_store_.EnableNetwork(); });
+
+  AckWrite(1);
+  worker_queue_->EnqueueBlocking([&] {
+    datastore_->FailWrite(Status(Error::kErrorInvalidArgument, "Rejected"));
+  });
+
+  EXPECT_EQ(events_, (std::vector<std::string>{Acknowledged({first}),
+                                               Rejected(second)}));
+  EXPECT_FALSE(ApplyIsScheduled());
+}
+
+TEST_F(RemoteStoreTest, AppliesAcknowledgementsWhenTheNetworkIsDisabled) {
+  BatchId first = WriteLocally("coll/a");
+  WriteLocally("coll/b");
+  worker_queue_->EnqueueBlocking([&] { remote_store_.EnableNetwork(); });
+
+  AckWrite(1);
+  worker_queue_->EnqueueBlocking([&] { remote_store_.DisableNetwork(); });
+  EXPECT_EQ(events_, std::vector<std::string>{Acknowledged({first})});
+  EXPECT_FALSE(ApplyIsScheduled());
+
+  // Only the unacknowledged write is sent again.
+  worker_queue_->EnqueueBlocking([&] { remote_store_.EnableNetwork(); });
+  EXPECT_EQ(datastore_->WritesSent(), 1);
+}
+
+TEST_F(RemoteStoreTest, DoesNotResendAcknowledgedWritesBeforeTheyAreApplied) {
+  BatchId first = WriteLocally("coll/a");
+  worker_queue_->EnqueueBlocking([&] { remote_store_.EnableNetwork(); });
+  datastore_->NextSentWrite();
+
+  // The acknowledged batch is still in the mutation queue, but refilling the
+  // write pipeline must skip it.
+  AckWrite(1);
+  EXPECT_EQ(datastore_->WritesSent(), 0);
+
+  WriteLocally("coll/b");
+  worker_queue_->EnqueueBlocking([&] { remote_store_.FillWritePipeline(); });
+  EXPECT_EQ(datastore_->WritesSent(), 1);
+
+  RunScheduledApply();
+  EXPECT_EQ(events_, std::vector<std::string>{Acknowledged({first})});
+}
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/util/log.h"
 
+#include <string>
+
 #include "gtest/gtest.h"
 
 namespace firebase {
@@ -47,6 +49,24 @@ TEST(LogTest, SetAndGet) {
   LogSetLevel(previous_level);
 }
 
+TEST(LogTest, ArgumentsCanLog) {
+  auto logging_arg = [] {
+    LOG_WARN("test logging while formatting %s", "an argument");
+    return std::string{"def"};
+  };
+  EXPECT_EQ("abc def", internal::LogFormat("%s %s", "abc", logging_arg()));
+}
+
+TEST(LogTest, ReleasesLongMessages) {
+  std::string long_arg(internal::kLogBufferMaxCapacity * 2, 'x');
+  internal::LogFormattedMessage(kLogLevelDebug, "test long message %s",
+                                long_arg);
+  EXPECT_LE(internal::LogBuffer().capacity(), internal::kLogBufferMaxCapacity);
+
+  internal::LogFormattedMessage(kLogLevelDebug, "test short message %s", 1);
+  EXPECT_EQ("test short message 1", internal::LogBuffer());
+}
+
 TEST(LogTest, LogAllKinds) {
   LOG_DEBUG("test debug logging %s", 1);
   LOG_WARN("test warning logging %s", 3);
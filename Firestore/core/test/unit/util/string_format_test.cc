@@ -105,6 +105,16 @@ TEST(StringFormatTest, Excess) {
   EXPECT_EQ("Hello World", StringFormat("Hello %s", "World", 42));
 }
 
+TEST(StringFormatTest, FormatTo) {
+  std::string dest = "Hello";
+  StringFormatTo(&dest, ", %s%s", "World", 42);
+  EXPECT_EQ("Hello, World42", dest);
+
+  dest.clear();
+  StringFormatTo(&dest, "%s%%", 100);
+  EXPECT_EQ("100%", dest);
+}
+
 }  //  namespace util
 }  //  namespace firestore
 }  //  namespace firebase
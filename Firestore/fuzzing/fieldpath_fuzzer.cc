@@ -30,6 +30,16 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
 
   try {
     StatusOr<FieldPath> fp = FieldPath::FromServerFormat(str);
+    if (fp.ok()) {
+      fp.ValueOrDie().CanonicalString();
+    }
+  } catch (...) {
+    // Ignore caught exceptions.
+  }
+
+  try {
+    FieldPath fp = FieldPath::FromDotSeparatedString(str);
+    fp.CanonicalString();
   } catch (...) {
     // Ignore caught exceptions.
   }
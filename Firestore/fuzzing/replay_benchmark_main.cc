@@ -0,0 +1,289 @@
+/*
+ * Copyright 2020 Google
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// A driver that replays a fuzzing target's corpus through its
+// `LLVMFuzzerTestOneInput` instead of fuzzing it, and reports how expensive
+// each input is: the time per run, and the number of allocations and peak
+// allocated bytes of a single run.
+//
+// To catch algorithmic-complexity blowups, each input is also replayed
+// repeated `--growth` times. Well-behaved parsers take about `--growth` times
+// as long on the repeated input, so the driver computes the exponent of the
+// growth in time, and flags inputs whose exponent exceeds `--max_exponent`.
+// The exit status is non-zero if any input was flagged.
+//
+// Usage:
+//   firestore_xyz_replay_benchmark [--growth=N] [--max_exponent=X] \
+//       corpus_dir_or_file...
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/util/filesystem.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+using firebase::firestore::util::DirectoryIterator;
+using firebase::firestore::util::Filesystem;
+using firebase::firestore::util::Path;
+using firebase::firestore::util::StatusOr;
+
+// Each input is run repeatedly for at least this long, to average out noise.
+constexpr std::chrono::milliseconds kMinMeasureDuration{10};
+
+// Repeated inputs faster than this are too noisy to draw conclusions from.
+constexpr double kNoiseFloorNanos = 1000;
+
+// The driver is single-threaded, so the allocation counters don't need to be
+// atomic.
+struct AllocationStats {
+  size_t count = 0;
+  size_t live_bytes = 0;
+  size_t peak_bytes = 0;
+};
+
+AllocationStats allocation_stats;
+
+// Every allocation is prefixed with its size, so that deallocation can keep
+// `live_bytes` up to date. The header keeps the returned pointer aligned.
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+void* CountedAllocate(size_t size) {
+  void* block = std::malloc(size + kHeaderSize);
+  if (!block) return nullptr;
+
+  *static_cast<size_t*>(block) = size;
+
+  allocation_stats.count++;
+  allocation_stats.live_bytes += size;
+  allocation_stats.peak_bytes =
+      std::max(allocation_stats.peak_bytes, allocation_stats.live_bytes);
+
+  return static_cast<char*>(block) + kHeaderSize;
+}
+
+void CountedFree(void* ptr) {
+  if (!ptr) return;
+
+  void* block = static_cast<char*>(ptr) - kHeaderSize;
+  allocation_stats.live_bytes -= *static_cast<size_t*>(block);
+  std::free(block);
+}
+
+struct Input {
+  std::string name;
+  std::string data;
+};
+
+struct Measurement {
+  double nanos_per_run = 0;
+  size_t allocations = 0;
+  size_t peak_bytes = 0;
+};
+
+void Run(const std::string& data) {
+  LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(data.data()),
+                         data.size());
+}
+
+Measurement Measure(const std::string& data) {
+  Measurement result;
+
+  // The first run also warms up any lazily initialized state.
+  size_t live_bytes = allocation_stats.live_bytes;
+  allocation_stats.count = 0;
+  allocation_stats.peak_bytes = live_bytes;
+  Run(data);
+  result.allocations = allocation_stats.count;
+  result.peak_bytes = allocation_stats.peak_bytes - live_bytes;
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point start = Clock::now();
+  Clock::duration elapsed;
+  int64_t runs = 0;
+  do {
+    Run(data);
+    ++runs;
+    elapsed = Clock::now() - start;
+  } while (elapsed < kMinMeasureDuration);
+
+  result.nanos_per_run =
+      std::chrono::duration<double, std::nano>(elapsed).count() / runs;
+  return result;
+}
+
+void ReadInput(const Path& path, std::vector<Input>* inputs) {
+  StatusOr<std::string> contents = Filesystem::Default()->ReadFile(path);
+  if (!contents.ok()) {
+    fprintf(stderr, "Could not read %s: %s\n", path.ToUtf8String().c_str(),
+            contents.status().ToString().c_str());
+    exit(2);
+  }
+  inputs->push_back({path.ToUtf8String(), std::move(contents).ValueOrDie()});
+}
+
+void ReadInputs(const Path& path, std::vector<Input>* inputs) {
+  if (!Filesystem::Default()->IsDirectory(path).ok()) {
+    ReadInput(path, inputs);
+    return;
+  }
+
+  for (auto iter = DirectoryIterator::Create(path); iter->Valid();
+       iter->Next()) {
+    ReadInput(iter->file(), inputs);
+  }
+}
+
+template <typename T, typename Parse>
+bool ParseFlag(absl::string_view arg,
+               absl::string_view name,
+               Parse parse,
+               T* value) {
+  if (!absl::StartsWith(arg, name)) return false;
+  arg.remove_prefix(name.size());
+
+  if (!parse(arg, value)) {
+    fprintf(stderr, "Invalid value for %s\n", std::string{name}.c_str());
+    exit(2);
+  }
+  return true;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  void* ptr = CountedAllocate(size);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
+int main(int argc, char** argv) {
+  int growth = 8;
+  double max_exponent = 1.5;
+  std::vector<Input> inputs;
+
+  auto parse_int = [](absl::string_view text, int* value) {
+    return absl::SimpleAtoi(text, value) && *value > 1;
+  };
+  auto parse_double = [](absl::string_view text, double* value) {
+    return absl::SimpleAtod(text, value);
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    absl::string_view arg = argv[i];
+    if (ParseFlag(arg, "--growth=", parse_int, &growth)) continue;
+    if (ParseFlag(arg, "--max_exponent=", parse_double, &max_exponent)) {
+      continue;
+    }
+
+    ReadInputs(Path::FromUtf8(arg), &inputs);
+  }
+
+  if (inputs.empty()) {
+    fprintf(stderr,
+            "Usage: %s [--growth=N] [--max_exponent=X] "
+            "corpus_dir_or_file...\n",
+            argv[0]);
+    return 2;
+  }
+
+  std::sort(inputs.begin(), inputs.end(),
+            [](const Input& lhs, const Input& rhs) {
+              return lhs.name < rhs.name;
+            });
+
+  printf("%10s %12s %8s %10s %14s %8s  %s\n", "bytes", "ns/run", "allocs",
+         "peak bytes", "grown ns/run", "exponent", "input");
+
+  int flagged = 0;
+  for (const Input& input : inputs) {
+    std::string grown;
+    for (int i = 0; i < growth; ++i) {
+      grown += input.data;
+    }
+
+    Measurement base = Measure(input.data);
+    Measurement repeated = Measure(grown);
+
+    double exponent = std::log(repeated.nanos_per_run / base.nanos_per_run) /
+                      std::log(static_cast<double>(growth));
+    bool superlinear = exponent > max_exponent &&
+                       repeated.nanos_per_run > kNoiseFloorNanos;
+    if (superlinear) ++flagged;
+
+    printf("%10zu %12.0f %8zu %10zu %14.0f %8.2f  %s%s\n", input.data.size(),
+           base.nanos_per_run, base.allocations, base.peak_bytes,
+           repeated.nanos_per_run, exponent, input.name.c_str(),
+           superlinear ? "  SUPERLINEAR" : "");
+  }
+
+  printf("%zu inputs, %d superlinear (growth %d, max exponent %.2f)\n",
+         inputs.size(), flagged, growth, max_exponent);
+  return flagged == 0 ? 0 : 1;
+}
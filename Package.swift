@@ -431,6 +431,7 @@ let package = Package(
       path: "Crashlytics",
       exclude: [
         "run",
+        "CMakeLists.txt",
         "CHANGELOG.md",
         "LICENSE",
         "README.md",